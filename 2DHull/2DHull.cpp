@@ -5,6 +5,11 @@
 * The convex hull simply connects all the exterior points to encapsulate all interior points.
 * The hull peel performs this until there are no points left. Removing the points used in the edges each time a convex hull is completed.
 * After a hull peel is completed, the number of points and edges is printed to the console for reference.
+* While a single convex hull is shown, adding points (with the mouse or by adding 100 points) keeps it current without rebuilding it.
+* The random points come from a seeded sampler, the seed is printed at startup and can be given as the first argument to repeat a run.
+* Peels run on a background job so the window stays responsive, with the number of layers peeled shown in the title, and X cancels them.
+* The convex hull can first throw away the points strictly inside the polygon of the extreme points (F switches between no filter, 4 and 8 directions),
+* and prints how many points the filter threw away.
 */
 
 #include <stdlib.h>
@@ -16,19 +21,44 @@
 #include <iostream>
 #include <vector>
 #include <algorithm>
+#include <chrono>
+#include <thread>
+#include <string>
+#include <functional>
+#include "../Geometry/halfedge.h"
+#include "../Geometry/hull.h"
+#include "../Geometry/grid.h"
+#include "../Geometry/sample.h"
+#include "../Geometry/job.h"
+#include "../Geometry/prep.h"
 using namespace std;
 
-//the point structure
-typedef struct
-{
-	int x, y; //x and y coordinates within the window
-} point;
+//the opengl buffer object constants and functions, which came after opengl 1.1 so they are looked up at runtime (see init_buffers)
+#ifndef GL_ARRAY_BUFFER
+#define GL_ARRAY_BUFFER 0x8892
+#define GL_ELEMENT_ARRAY_BUFFER 0x8893
+#define GL_STATIC_DRAW 0x88E4
+#endif
+typedef void (APIENTRY *gen_buffers_fn)(GLsizei n, GLuint* buffers);
+typedef void (APIENTRY *bind_buffer_fn)(GLenum target, GLuint buffer);
+typedef void (APIENTRY *buffer_data_fn)(GLenum target, ptrdiff_t size, const void* data, GLenum usage);
+
+//enums for the buffers the window is drawn from
+enum {
+	BUFFER_POINTS, BUFFER_VERTICES, BUFFER_EDGES, BUFFER_COUNT
+};
 
-//the edge structure
+//the draw buffers structure, holding the points and edges as they were last uploaded, so a frame is drawn with a few calls instead of one for each vertex
 typedef struct
 {
-	point p1, p2; //the two points making up an edge
-} edge;
+	bool stale; //true when the points or hull may have changed since they were last uploaded
+	GLuint names[BUFFER_COUNT]; //the buffer objects for the points, the hull vertices and the edges
+	vector<GLuint> edges; //the two vertices of every edge, as indices into the hull vertices
+	GLsizei pointCount, edgeCount; //the number of points and edge indices uploaded
+	gen_buffers_fn genBuffers; //the buffer object functions, NULL when opengl doesn't have them, in which case the arrays are drawn from memory
+	bind_buffer_fn bindBuffer;
+	buffer_data_fn bufferData;
+} draw_buffers;
 
 //the global structure
 typedef struct
@@ -36,35 +66,161 @@ typedef struct
 	int w, h; //w for width and h for height of the window
 	int n; //number of points to create
 	vector<point> points; //vector of points
-	vector<point> coords; //vector for all possible coordinates
-	vector<edge> edges; //vector of edges
+	point_keys keys; //the keys of the points, for rejecting a duplicate mouse point in O(1), cleared whenever the points are replaced
+	sampler sample; //the sampler drawing random points from all possible coordinates
+	rng generator; //the random number generator seeding each new sample
+	unsigned long long seed; //the seed of the random number generator, printed so a run can be repeated
+	halfedge_mesh hull; //the hull layers, one polygon face for each
+	online_hull online; //the online hull of the points, kept current as points are added while a convex hull is shown
+	bool liveHull; //true when the hull mesh shows a single convex hull, which is updated as points are added instead of cleared
 	bool mouseDraw; //true when drawing points with the mouse
-	bool shuffled; //true when the coords vector has been shuffled
+	bool sampled; //true when the points have been drawn from the sampler
 	int clusters; //the number of clusters to create
-	bool clustering; //true when we are clustering points
+	int hullMethod; //the algorithm used by convex_hull, either HULL_QUICK or HULL_MONOTONE
+	int threads; //the number of threads used by convex_hull and cluster_peel, 1 for a single thread
+	int hullFilter; //the interior point filter run by convex_hull before the hull, one of the HULL_FILTER enums
+	draw_buffers buffers; //the points and edges uploaded for drawing
+	job work; //the background job, running a peel or cluster peel off the window thread so the window stays responsive
+	int jobKind; //what the job is doing, JOB_NONE when there is no job
+	vector<point> jobPoints; //the points the job works on, copied when it starts, a cluster peel leaves the points that were not clustered in it
+	halfedge_mesh jobHull; //the hull mesh the job adds its layers to, copied when it starts, only touched by the job until it has been collected
+	hull_scratch scratch; //the temporary arrays of the hulls and peels, kept from one run to the next so they don't allocate again
 } glob;
 glob global;
 
 //enums for the menu buttons/options
 enum {
-	MENU_QUIT, MENU_RANDOM, MENU_CONVEX, MENU_PEEL, MENU_INCREMENT, MENU_MOUSE, MENU_CLUSTER, MENU_CLUSTER_INCREMENT
+	MENU_QUIT, MENU_RANDOM, MENU_CONVEX, MENU_PEEL, MENU_INCREMENT, MENU_MOUSE, MENU_CLUSTER, MENU_CLUSTER_INCREMENT, MENU_HULL_METHOD, MENU_HULL_THREADS, MENU_HULL_FILTER, MENU_CANCEL
 };
 
+//the names of the interior point filters, in the same order as the HULL_FILTER enums
+const char* filterNames[] = { "no filter", "4 direction filter", "8 direction filter" };
+
+//enums for what the background job is doing
+enum {
+	JOB_NONE, JOB_PEEL, JOB_CLUSTER
+};
+
+//the title of the window, which shows the progress of the background job after it while one is running
+const char WINDOW_TITLE[] = "2D Hull Peeler";
+
+//the time between checks on a running job, in milliseconds
+const int JOB_POLL_MS = 100;
+
+//this method checks if the background job is running, letting the user know it has to finish or be cancelled first
+//anything that changes the points or hull mesh waits for the job, as they are replaced with what it made once it is collected
+bool job_busy()
+{
+	if (!job_running(global.work))
+		return false;
+
+	cout << "Still working, wait for the job to finish or press X to cancel it." << endl;
+	return true;
+}
+
+//this method uses the results of the background job once it has been collected, replacing the global points and hull mesh with the ones it made
+//nothing is replaced if the job was cancelled
+void finish_job()
+{
+	glutSetWindowTitle(WINDOW_TITLE);
+
+	if (global.work.progress.cancel)
+		cout << "Job cancelled." << endl;
+	else if (global.jobKind == JOB_PEEL)
+	{
+		//let the user know how many points were used and how many edges were created
+		cout << "Peel completed with " << global.jobPoints.size() << " points and " << global.jobHull.origin.size() << " edges." << endl;
+		swap(global.hull, global.jobHull);
+
+		//clear the global points vector as it looks nicer without the points when a peel is performed
+		global.points.clear();
+		keys_clear(global.keys);
+	}
+	else
+	{
+		cout << "Cluster peel completed with " << global.jobHull.origin.size() << " edges, leaving " << global.jobPoints.size() << " points." << endl;
+		swap(global.hull, global.jobHull);
+		global.points.swap(global.jobPoints);
+		keys_clear(global.keys);
+	}
+
+	//empty the copies the job worked on, keeping their memory for the next job
+	global.jobPoints.clear();
+	he_reset(global.jobHull);
+	global.jobKind = JOB_NONE;
+	global.buffers.stale = true;
+	glutPostRedisplay();
+}
+
+//this method checks on the background job every JOB_POLL_MS, showing its progress in the window title until it can be collected
+void poll_job(int value)
+{
+	if (job_collect(global.work))
+	{
+		finish_job();
+		return;
+	}
+
+	string title = string(WINDOW_TITLE) + (global.jobKind == JOB_PEEL ? " - peeling: " : " - cluster peeling: ") + to_string(global.work.progress.done.load()) + " layers (X to cancel)";
+	glutSetWindowTitle(title.c_str());
+	glutTimerFunc(JOB_POLL_MS, poll_job, 0);
+}
+
+//this method starts the background job, running work on copies of the global points and hull mesh
+//the window keeps drawing the points and hull as they were until poll_job collects the job
+void start_job(int kind, const function<void(job_progress&)>& work)
+{
+	global.jobKind = kind;
+	global.jobPoints = global.points;
+	global.jobHull = global.hull;
+	job_start(global.work, work);
+	glutTimerFunc(JOB_POLL_MS, poll_job, 0);
+}
+
+//this method cancels the background job, which poll_job collects once it has stopped
+void cancel_job()
+{
+	if (!job_running(global.work))
+		return;
+
+	job_cancel(global.work);
+	cout << "Cancelling..." << endl;
+}
+
+//this method quits the program, stopping the background job first
+void quit()
+{
+	job_cancel(global.work);
+	job_wait(global.work);
+	exit(0);
+}
+
+//initialize the sampler for coordinates, with a new seed from the random number generator
+void initializeSampler()
+{
+	//the sampler covers all possible combinations of x and y (making sure points are only drawn within the visual bounds of the screen!)
+	sampler_init(global.sample, 1, 1, global.w - 10, global.h - 10, rng_next(global.generator));
+}
+
 //this method creates a set of random points within the bounds of the window
-//the point and edge vectors are cleared to ensure the new points are added to an empty vector
+//the point vector and hull mesh are cleared to ensure the new points are added to an empty vector
 void random()
 {
-	vector<point>().swap(global.points); //clear the points vector, getting rid of its contents and freeing some memory
-	vector<edge>().swap(global.edges); //clear the edges vector, getting rid of its contents and freeing some memory
-	random_shuffle(global.coords.begin(), global.coords.end()); //shuffle the coordinate vector
+	if (job_busy())
+		return;
+
+	global.points.clear(); //empty the points vector, keeping its memory for the new points
+	keys_clear(global.keys);
+	he_reset(global.hull); //empty the hull mesh, keeping its memory for the next one
+	global.liveHull = false;
+	initializeSampler(); //start a new sample, so the points come in a new order
 
-	//we have shuffled, so set the shuffle bool to true if it isn't already
-	if (!global.shuffled)
-		global.shuffled = true;
+	//we have sampled, so set the sample bool to true if it isn't already
+	if (!global.sampled)
+		global.sampled = true;
 
-	//create 'n' random points from the vector of possible points based on the window size
-	for (int i = 0; i < global.n; i++)
-		global.points.push_back(point{ global.coords[i].x, global.coords[i].y }); //add the new point to the point vector
+	//draw 'n' random points from the possible points based on the window size
+	sampler_take(global.sample, global.n, global.points);
 
 	glutPostRedisplay(); //redisplay the window
 }
@@ -73,8 +229,13 @@ void random()
 //only used for development, not necessary for the program/assignment
 void lattice()
 {
-	vector<point>().swap(global.points); //clear the points vector, getting rid of its contents and freeing some memory
-	vector<edge>().swap(global.edges); //clear the edges vector, getting rid of its contents and freeing some memory
+	if (job_busy())
+		return;
+
+	global.points.clear(); //empty the points vector, keeping its memory for the new points
+	keys_clear(global.keys);
+	he_reset(global.hull); //empty the hull mesh, keeping its memory for the next one
+	global.liveHull = false;
 
 	//create 100 points in a 10x10 lattice
 	for (int i = 0; i < 10; i++)
@@ -84,20 +245,51 @@ void lattice()
 	glutPostRedisplay(); //redisplay the window
 }
 
+//this method updates the hull mesh after the points from index first onwards have been added to the global points
+//when a single convex hull is shown, the new points are inserted into the online hull, and the hull mesh is only rebuilt if one of them became a hull vertex
+//points inside the hull are rejected in O(log h), so adding points one at a time never needs a full convex hull pass
+//otherwise the hull mesh no longer matches the points, so it is cleared
+void update_hull(int first)
+{
+	if (!global.liveHull)
+	{
+		he_reset(global.hull); //empty the hull mesh, keeping its memory for the next one
+		return;
+	}
+
+	bool changed = false;
+	for (int i = first; i < global.points.size(); i++)
+		if (online_hull_insert(global.online, global.points, i))
+			changed = true;
+
+	if (changed)
+	{
+		vector<int> ring;
+		online_hull_ring(global.online, ring);
+
+		he_reset(global.hull);
+		if (!ring.empty())
+			he_add_ring(global.hull, global.points, ring);
+	}
+}
+
 //create a point where the mouse clicks
 //this method ensures that each point is unique and places the points correctly based on the mouse position in the window
 //the y value has to be essentially inversed as 0 in the window is bottom left and 0 for the mouse position is top left
 void draw_mouse_point(int x, int y)
 {
+	if (job_busy())
+		return;
+
 	y = global.h - 10 - y; //subtract the value of y from the max y coordinate
 
-	//ensure the point is unique from all other points
-	for (const point& p : global.points)
-		if (p.x == x && p.y == y)
-			return;
+	//ensure the point is unique from all other points, looking it up in the keys of the points rather than scanning them
+	keys_sync(global.keys, global.points);
+	if (keys_has(global.keys, point{ x, y }))
+		return;
 
 	global.points.push_back(point{ x, y }); //add the point to the global points vector
-	vector<edge>().swap(global.edges); //clear the edges vector, getting rid of its contents and freeing some memory
+	update_hull(global.points.size() - 1); //add the point to the hull if one is shown, otherwise clear the hull mesh
 
 	glutPostRedisplay(); //redisplay the window
 }
@@ -106,276 +298,265 @@ void draw_mouse_point(int x, int y)
 //it calls the draw_mouse_point when the user is creating points with the mouse and has left clicked somewhere in the window
 void mouse(int bin, int state, int x, int y)
 {
-	if (global.mouseDraw && bin == GLUT_LEFT_BUTTON && state == GLUT_DOWN) draw_mouse_point(x, y);
-}
-
-//this method is an implementation of the QuickHull algorithm
-//the coefficients to calculated the distance are calculated first
-//points for the max and direction vectors are created, and the ints for distance are initialized
-//then all points are iterated through, finding the point with the max distance from the line
-//if no point is found, that means either all points are interior to the line or there are colinear points
-//that means that the edge is added to the global edge vector
-//if a point is found, quick_hull is called on the two lines from pMax to the original two points
-void quick_hull(vector<point> points, point p1, point p2)
-{
-	//set the coefficients
-	int a = p1.y - p2.y;
-	int b = p2.x - p1.x;
-	int c = p1.x * p2.y - p1.y * p2.x;
-
-	//initalize the points and ints
-	point pMax = point{ 0, 0 };
-	int maxD = 0;
-	int d;
-	point dir_p1_p, dir_p_p2;
-
-	//iterate through all points, finding the max distance points
-	for (const point& p : points)
+	if (global.mouseDraw && bin == GLUT_LEFT_BUTTON && state == GLUT_DOWN)
 	{
-		if (!(p.x == p1.x && p.y == p1.y || p.x == p2.x && p.y == p2.y))
-		{
-			d = a * p.x + b * p.y + c;
-
-			if (d > maxD)
-			{
-				pMax = p;
-				maxD = d;
-			}
-		}
+		global.buffers.stale = true; //the point may be added, so upload the points again on the next draw
+		draw_mouse_point(x, y);
 	}
+}
 
-	//if no point is found, add the edge to the vector
-	if (maxD == 0)
-	{
-		global.edges.push_back(edge{ p1, p2 });
+//this method creates a convex hull using the algorithm set by global.hullMethod, adding it to the global hull mesh as a new face
+//the indices of the hull vertices are left in ring, and the number of points thrown away by the filter set by global.hullFilter is returned
+int convex_hull(const vector<point>& points, vector<int>& ring)
+{
+	int removed = filtered_hull(points, global.hullMethod, global.threads, global.hullFilter, ring, global.scratch);
+
+	if (!ring.empty())
+		he_add_ring(global.hull, points, ring);
+
+	glutPostRedisplay(); //redisplay the window
+	return removed;
+}
+
+//this method creates a convex hull of the global points and prints how long it took
+//this is used to compare the speed of the hull algorithms on the same set of points
+void timed_convex_hull()
+{
+	if (job_busy())
 		return;
-	}
 
-	//recursively call quick_hull
-	quick_hull(points, p1, pMax);
-	quick_hull(points, pMax, p2);
+	he_reset(global.hull); //empty the hull mesh so only this hull is timed and drawn
+
+	vector<int> ring;
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	int removed = convex_hull(global.points, ring);
+	chrono::duration<double, milli> elapsed = chrono::steady_clock::now() - start;
+
+	//start the online hull from the new hull, so points added from now on keep it current
+	online_hull_init(global.online, global.points, ring);
+	global.liveHull = true;
+
+	cout << "Convex hull (" << (global.hullMethod == HULL_MONOTONE ? "monotone chain" : "quick hull") << ", " << global.threads << " threads, " << filterNames[global.hullFilter] << ") completed with " << global.hull.origin.size() << " edges in " << elapsed.count() << " ms." << endl;
+	if (global.hullFilter != HULL_FILTER_NONE)
+		cout << "The filter threw away " << removed << " of " << global.points.size() << " points." << endl;
+}
+
+//this method switches the algorithm used by convex_hull between quick hull and monotone chain
+void switch_hull_method()
+{
+	global.hullMethod = global.hullMethod == HULL_QUICK ? HULL_MONOTONE : HULL_QUICK;
+	cout << "Hull method set to " << (global.hullMethod == HULL_MONOTONE ? "monotone chain" : "quick hull") << endl;
+}
+
+//this method switches convex_hull and cluster_peel between a single thread and one thread for each core of the machine
+void switch_hull_threads()
+{
+	int cores = max(1, (int)thread::hardware_concurrency());
+	global.threads = global.threads == 1 ? cores : 1;
+	cout << "Hull threads set to " << global.threads << endl;
+}
+
+//this method switches the filter run by convex_hull between no filter, the 4 direction filter and the 8 direction filter
+void switch_hull_filter()
+{
+	global.hullFilter = (global.hullFilter + 1) % 3;
+	cout << "Hull filter set to " << filterNames[global.hullFilter] << endl;
 }
 
-//this method creates a convex hull using the quick hull algorithm
-//the method finds the point with the minimum x and maximum x values
-//then, quick_hull is called for both directions of the line, ensuring we create a top and bottom to the hull
-void convex_hull(vector<point> points)
+//this method adds the hull layers of the points to the hull mesh, each layer as a face, counting each layer peeled in the progress
+//this runs on the job thread, so it only touches what it is given, keeping the temporary arrays of the peel in the scratch
+//returns false if the job was cancelled
+bool peel_points(const vector<point>& points, halfedge_mesh& hull, hull_scratch& scratch, job_progress& progress)
 {
-	//if there are less than three points, we cannot create a convex hull so immediately stop
-	if (points.size() < 3)
+	vector<vector<int>> layers;
+	if (!peel_layers(points, layers, scratch, progress))
+		return false;
+
+	for (const vector<int>& layer : layers)
+		he_add_ring(hull, points, layer);
+	return true;
+}
+
+//this method conducts a hull peel of the global points on the background job
+//all the hull layers are found with peel_layers, then each layer is added to the hull mesh as a face
+void peel()
+{
+	if (job_busy())
 		return;
 
-	//initialize the min and max points
-	point minPoint;
-	minPoint.x = global.w;
-	point maxPoint;
-	maxPoint.x = -1;
+	global.liveHull = false; //the hull mesh holds layers now, not a single convex hull
+	start_job(JOB_PEEL, [](job_progress& progress) { peel_points(global.jobPoints, global.jobHull, global.scratch, progress); });
+}
+
+//this method creates cluster peels based on the set number of clusters to create, on the background job
+//the global points are split into clusters of the nearest n / clusters points with make_clusters, and the clusters are peeled on global.threads threads
+//once all clusters are peeled, the global points vector is left with only the points that were not clustered
+void cluster_peel()
+{
+	if (job_busy())
+		return;
 
-	//iterate through all points and find the min and max
-	for (const point& p : points)
+	global.liveHull = false;
+	int clusters = global.clusters, size = global.n / global.clusters, threads = global.threads;
+	start_job(JOB_CLUSTER, [clusters, size, threads](job_progress& progress)
 	{
-		if (p.x < minPoint.x)
-			minPoint = p;
-		if (p.x > maxPoint.x)
-			maxPoint = p;
-	}
+		//initialize variables
+		vector<vector<int>> groups;
+		vector<int> leftover;
+		vector<vector<vector<int>>> layers;
+		const vector<point>& points = global.jobPoints;
 
-	//call quick hull for both directions of the line
-	quick_hull(points, minPoint, maxPoint);
-	quick_hull(points, maxPoint, minPoint);
+		make_clusters(points, clusters, size, groups, leftover);
 
-	glutPostRedisplay(); //redisplay the window
+		//peel the clusters, then add their layers to the hull mesh in cluster order
+		if (!peel_clusters(points, groups, threads, layers, progress))
+			return;
+		for (const vector<vector<int>>& cluster : layers)
+			for (const vector<int>& layer : cluster)
+				he_add_ring(global.jobHull, points, layer);
+
+		//keep only the points that were not added to a cluster
+		vector<point> newPoints;
+		for (int j : leftover)
+			newPoints.push_back(points[j]);
+		global.jobPoints.swap(newPoints);
+	});
 }
 
-//this method conducts a hull peel
-//while there are at least three points, call convex hull, then remove the points from the hull edges and call convex hull again
-//this checks if any point in the points vector is in the edges vector by finding the distance of a point from the current edge
-//after finding which points are not already in a convex hull, the points vector is set to a new set of points
-void peel(vector<point> points)
+//this method looks up the buffer object functions, once there is an opengl context, and creates the buffers
+//buffer objects need opengl 1.5, without it the functions are left NULL and the points and edges are drawn from memory as vertex arrays
+void init_buffers()
 {
-	//initialize the variables
-	vector<point> newPoints;
-	bool pointExists;
-	int a, b, c, d;
+	draw_buffers& b = global.buffers;
+	b.stale = true;
 
-	//as long as there are at least three points, we can do a convex hull
-	while (points.size() > 2)
-	{
-		convex_hull(points); //call convex hull to do a hull of the current vector of points
-		vector<point>().swap(newPoints); //clear the new points vector, getting rid of its contents and freeing some memory
-
-		//iterate through all points to determine which points already are in a convex hull
-		for (const point& p : points)
-		{
-			pointExists = false; //make sure we don't think the point already exists before checking
-
-			//iterate though all edges to determine if the point p is already on a calculated edge
-			for (const edge& e : global.edges)
-			{
-				//calculate the distance of the point from the edge
-				a = e.p1.y - e.p2.y;
-				b = e.p2.x - e.p1.x;
-				c = e.p1.x * e.p2.y - e.p1.y * e.p2.x;
-				d = a * p.x + b * p.y + c;
-
-				//if the point lies on the line, it already is in the edge vector, and we can say it exists, so stop looking for a matching edge point
-				if (d == 0)
-				{
-					pointExists = true;
-					break;
-				}
-			}
-
-			//if we don't find the point on any edge, add it to the new points vector
-			if (!pointExists)
-				newPoints.push_back(p);
-		}		
-
-		vector<point>().swap(points); //clear the points vector, getting rid of its contents and freeing some memory
-		//add all points from the new points vector to the global points vector
-		for (int i = 0; i < newPoints.size(); i++)
-			points.push_back(newPoints[i]);
-	}
-	
-	//let the user know how many points were used and how many edges were created
-	cout << "Peel completed with " << global.points.size() << " points and " << global.edges.size() << " edges." << endl;
+	int major = 0, minor = 0;
+	const char* version = (const char*)glGetString(GL_VERSION);
+	if (version == NULL || sscanf(version, "%d.%d", &major, &minor) != 2 || major * 10 + minor < 15)
+		return;
 
-	//clear the global points vector as it looks nicer without the points when a peel is performed
-	//only do this if we are not clustering points
-	if (!global.clustering)
+	b.genBuffers = (gen_buffers_fn)glutGetProcAddress("glGenBuffers");
+	b.bindBuffer = (bind_buffer_fn)glutGetProcAddress("glBindBuffer");
+	b.bufferData = (buffer_data_fn)glutGetProcAddress("glBufferData");
+	if (b.genBuffers == NULL || b.bindBuffer == NULL || b.bufferData == NULL)
 	{
-		vector<point>().swap(global.points);
-		glutPostRedisplay();
+		b.genBuffers = NULL;
+		b.bindBuffer = NULL;
+		b.bufferData = NULL;
+		return;
 	}
+
+	b.genBuffers(BUFFER_COUNT, b.names);
 }
 
-//this method returns the distance between two points using pythagorean theorem
-int pythagorean(point p1, point p2)
+//this method copies size bytes of data into one of the buffers, when there are buffer objects
+void upload_buffer(GLenum target, int buffer, const void* data, size_t size)
 {
-	return sqrt((p2.x - p1.x) * (p2.x - p1.x) + (p2.y - p1.y) * (p2.y - p1.y));
+	draw_buffers& b = global.buffers;
+	if (b.bufferData == NULL)
+		return;
+
+	b.bindBuffer(target, b.names[buffer]);
+	b.bufferData(target, (ptrdiff_t)size, data, GL_STATIC_DRAW);
+	b.bindBuffer(target, 0);
 }
 
-//this method creates cluster peels based on the set number of clusters to create
-//it finds the first point in the global points vector, finds the nearest points, and performs a hull peel on that
-//then it removes those points and continues until all points have been peeled
-void cluster_peel()
+//this method uploads the global points, the hull vertices and the hull edges, which are then drawn from the buffers until they change again
+//each half edge of the hull mesh becomes a line from its vertex to the next one around its face
+void upload_buffers()
 {
-	//initialize variables
-	vector<point> clusterPoints, newPoints;
-	int dist;
-	bool pointExists;
-	global.clustering = true;
+	draw_buffers& b = global.buffers;
+	const halfedge_mesh& m = global.hull;
 
-	//create the number of clusters set by global.clusters (default 5)
-	for (int i = 0; i < global.clusters; i++)
+	b.edges.clear();
+	for (int h = 0; h < m.origin.size(); h++)
 	{
-		dist = 1; //reset the distance
-		vector<point>().swap(clusterPoints); //clear the clusterPoints vector and free some memory
-		vector<point>().swap(newPoints);
-		clusterPoints.push_back(global.points[0]);
-
-		//add the closest n / clusters points to the clusterPoints vector
-		//very inefficiently checks all progressive distances until enough points are added
-		while (clusterPoints.size() < global.n / global.clusters)
-		{
-			for (const point& p : global.points)
-			{
-				if (clusterPoints.size() >= global.n / global.clusters)
-					break;
-
-				if (pythagorean(clusterPoints[0], p) == dist)
-					clusterPoints.push_back(p);
-			}
-
-			dist++;
-		}
-
-		peel(clusterPoints); //peel the points
-
-		//ensure the global points vector no longer contains points that were added to the cluster
-		//iterate through all points to determine which points already are in the cluster
-		for (const point& p1 : global.points)
-		{
-			pointExists = false; //make sure we don't think the point already exists before checking
-
-			//iterate though all points to determine if the point p1 is already in the cluster
-			for (const point& p2 : clusterPoints)
-				if (p1.x == p2.x && p1.y == p2.y)
-					pointExists = true;
-
-			//if we don't find the point, add it to the new points vector
-			if (!pointExists)
-				newPoints.push_back(p1);
-		}
-
-		vector<point>().swap(global.points); //clear the points vector, getting rid of its contents and freeing some memory
-		//add all points from the new points vector to the global points vector
-		for (int j = 0; j < newPoints.size(); j++)
-			global.points.push_back(newPoints[j]);
+		b.edges.push_back(m.origin[h]);
+		b.edges.push_back(he_target(m, h));
 	}
 
-	global.clustering = false;
+	b.pointCount = (GLsizei)global.points.size();
+	b.edgeCount = (GLsizei)b.edges.size();
+	upload_buffer(GL_ARRAY_BUFFER, BUFFER_POINTS, global.points.data(), global.points.size() * sizeof(point));
+	upload_buffer(GL_ARRAY_BUFFER, BUFFER_VERTICES, m.points.data(), m.points.size() * sizeof(point));
+	upload_buffer(GL_ELEMENT_ARRAY_BUFFER, BUFFER_EDGES, b.edges.data(), b.edges.size() * sizeof(GLuint));
+	b.stale = false;
+}
+
+//this method binds one of the buffers to be drawn from, returning where its data starts for glVertexPointer or glDrawElements
+//that is offset 0 in the bound buffer object, or data itself when the arrays are drawn from memory
+const void* bind_buffer(GLenum target, int buffer, const void* data)
+{
+	draw_buffers& b = global.buffers;
+	if (b.bindBuffer == NULL)
+		return data;
+
+	b.bindBuffer(target, b.names[buffer]);
+	return NULL;
 }
 
 //this method draws the points and edges to the window, showing the work done by the hull algorithms
+//the points and edges are only uploaded when they have changed, then each frame draws all the points with one call and all the edges with another
 void draw()
 {
 	glClear(GL_COLOR_BUFFER_BIT); //make sure to clear the screen before drawing new points
 
+	draw_buffers& b = global.buffers;
+	if (b.stale)
+		upload_buffers();
+
 	glPointSize(3.0); //set the size of the points larger so they are easier to see
 	glColor3f(1.0, 1.0, 1.0); //set them to white
-
-	//begin drawing points on screen
-	glBegin(GL_POINTS);
+	glEnableClientState(GL_VERTEX_ARRAY);
 
 	//draw all the points in the global points vector onto the screen
-	for (const point& p : global.points)
-		glVertex2i(p.x, p.y);
-
-	//stop drawing points
-	glEnd();
+	glVertexPointer(2, GL_INT, sizeof(point), bind_buffer(GL_ARRAY_BUFFER, BUFFER_POINTS, global.points.data()));
+	glDrawArrays(GL_POINTS, 0, b.pointCount);
 
-	//begin drawing lines on screen
-	glBegin(GL_LINES);
+	//draw all the edges in the global hull mesh onto the screen, as lines between the hull vertices
+	glVertexPointer(2, GL_INT, sizeof(point), bind_buffer(GL_ARRAY_BUFFER, BUFFER_VERTICES, global.hull.points.data()));
+	glDrawElements(GL_LINES, b.edgeCount, GL_UNSIGNED_INT, bind_buffer(GL_ELEMENT_ARRAY_BUFFER, BUFFER_EDGES, b.edges.data()));
 
-	//draw all the edges in the global edges vector onto the screen
-	for (const edge& e : global.edges)
+	//stop drawing from the buffers and flush to screen
+	if (b.bindBuffer != NULL)
 	{
-		glVertex2i(e.p1.x, e.p1.y);
-		glVertex2i(e.p2.x, e.p2.y);
+		b.bindBuffer(GL_ARRAY_BUFFER, 0);
+		b.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 	}
-
-	//stop drawing and flush the buffer to screen
-	glEnd();
+	glDisableClientState(GL_VERTEX_ARRAY);
 	glFlush();
 }
 
 //this method increments the global n value by 100
 //this is used to add 100 more points to the global points vector for generating random points
-//it ensures that the number of points will not exceed the size of the coords vector of all possible points
+//the new points carry on from the current sample, so they never repeat a point already drawn
+//it ensures that the number of points will not exceed the number of possible points
 void increment_n()
 {
-	//if the global n is already at the size of the coordinate vector, inform the user and don't increment
-	if (global.n == global.coords.size())
+	if (job_busy())
+		return;
+
+	//if the sampler has already drawn every possible point, inform the user and don't increment
+	if (sampler_remaining(global.sample) == 0)
 	{
-		cout << "No more than " << global.n << " points allowed at current screen size!" << endl;
+		cout << "No more than " << global.sample.size << " points allowed at current screen size!" << endl;
 		return;
 	}
 
-	//check if the program has already shuffled the coords vector, if not, shuffle it
-	if (!global.shuffled)
+	//check if the program has already drawn from the sampler, if not, start with the first n points
+	int count = 100;
+	if (!global.sampled)
 	{
-		random_shuffle(global.coords.begin(), global.coords.end()); //shuffle the coordinate vector
-		global.shuffled = true;
-		global.n -= 100;
+		global.sampled = true;
+		count = global.n;
+		global.n = 0;
 	}
 
-	//add 100 points to the global points vector
-	global.n += 100;
-	for (int i = global.points.size(); i < global.n; i++)
-		global.points.push_back(point{ global.coords[i].x, global.coords[i].y }); //add the new point to the point vector
-		
-	vector<edge>().swap(global.edges); //clear the edges vector, getting rid of its contents and freeing some memory
+	//add up to 100 points to the global points vector, fewer if the sampler runs out
+	int first = global.points.size();
+	global.n += sampler_take(global.sample, count, global.points);
+
+	update_hull(first); //add the new points to the hull if one is shown, otherwise clear the hull mesh
 	glutPostRedisplay(); //redisplay the window
 }
 
@@ -398,20 +579,33 @@ void increment_clusters()
 //this method sets the global mouse draw bool to its opposite, and clears the global points vector is mouseDraw was set to true
 void set_mouse_draw()
 {
+	if (job_busy())
+		return;
+
 	global.mouseDraw = !global.mouseDraw;
 	if (global.mouseDraw)
+	{
 		vector<point>().swap(global.points);
+		keys_clear(global.keys);
+		global.liveHull = false;
+	}
 }
 
 /*glut keyboard function*/
 void keyboard(unsigned char key, int x, int y)
 {
+	global.buffers.stale = true; //any action can change the points or hull, so upload them again on the next draw
+
 	switch (key)
 	{
 	case 0x1B:
 	case'q':
 	case 'Q':
-		exit(0);
+		quit();
+		break;
+	case 'x':
+	case 'X':
+		cancel_job();
 		break;
 	case 'r':
 	case 'R':
@@ -423,11 +617,11 @@ void keyboard(unsigned char key, int x, int y)
 		break;
 	case 'c':
 	case 'C':
-		convex_hull(global.points);
+		timed_convex_hull();
 		break;
 	case 'p':
 	case 'P':
-		peel(global.points);
+		peel();
 		break;
 	case 'l':
 	case 'L':
@@ -445,26 +639,42 @@ void keyboard(unsigned char key, int x, int y)
 	case 'Y':
 		increment_clusters();
 		break;
+	case 'h':
+	case 'H':
+		switch_hull_method();
+		break;
+	case 't':
+	case 'T':
+		switch_hull_threads();
+		break;
+	case 'f':
+	case 'F':
+		switch_hull_filter();
+		break;
 	}
 }//keyboard
 
 //Glut menu callback function
 void menuFunc(int value)
 {
+	global.buffers.stale = true; //any action can change the points or hull, so upload them again on the next draw
+
 	switch (value)
 	{
 	case MENU_QUIT:
-		exit(0);
+		quit();
 		break;
+	case MENU_CANCEL:
+		cancel_job();
 		break;
 	case MENU_RANDOM:
 		random();
 		break;
 	case MENU_CONVEX:
-		convex_hull(global.points);
+		timed_convex_hull();
 		break;
 	case MENU_PEEL:
-		peel(global.points);
+		peel();
 		break;
 	case MENU_INCREMENT:
 		increment_n();
@@ -478,6 +688,15 @@ void menuFunc(int value)
 	case MENU_CLUSTER_INCREMENT:
 		increment_clusters();
 		break;
+	case MENU_HULL_METHOD:
+		switch_hull_method();
+		break;
+	case MENU_HULL_THREADS:
+		switch_hull_threads();
+		break;
+	case MENU_HULL_FILTER:
+		switch_hull_filter();
+		break;
 	}
 
 	glutPostRedisplay();
@@ -486,7 +705,7 @@ void menuFunc(int value)
 //show the keys for actions in the terminal
 void show_keys()
 {
-	printf("Q:quit\nR:random\nM:mouse selection\nA:Add 100 points\nC:convex hull\nP:peel\nU:cluster peel\nY:increment clusters\n");
+	printf("Q:quit\nR:random\nM:mouse selection\nA:Add 100 points\nC:convex hull\nP:peel\nU:cluster peel\nY:increment clusters\nH:switch hull method\nT:switch hull threads\nF:switch hull filter\nX:cancel job\n");
 }
 
 //Glut menu set up
@@ -501,35 +720,38 @@ void init_menu()
 	glutAddMenuEntry("Hull Peel", MENU_PEEL);
 	glutAddMenuEntry("Cluster Peel", MENU_CLUSTER);
 	glutAddMenuEntry("Increment Clusters", MENU_CLUSTER_INCREMENT);
+	glutAddMenuEntry("Switch Hull Method", MENU_HULL_METHOD);
+	glutAddMenuEntry("Switch Hull Threads", MENU_HULL_THREADS);
+	glutAddMenuEntry("Switch Hull Filter", MENU_HULL_FILTER);
+	glutAddMenuEntry("Cancel Job", MENU_CANCEL);
 	glutAddMenuEntry("Quit", MENU_QUIT);
 	glutAttachMenu(GLUT_RIGHT_BUTTON);
 }
 
-//initialize the vector for coordinates
-void initializeVector()
-{
-	//initialize coordinate vector, going through all possible combinations of x and y (making sure points are only drawn within the visual bounds of the screen!)
-	for (int x = 1; x < global.w - 9; x++)
-		for (int y = 1; y < global.h - 9; y++)
-			global.coords.push_back(point{ x, y }); //add the point to the global vector of points
-}
-
 //what runs the whole show
 int main(int argc, char** argv)
 {
-	srand(static_cast <unsigned> (time(0))); //set a new random seed
-
 	global.w = 1000; //width and height set to 1000 x 800
 	global.h = 800;
 	global.n = 100; //set default number of points to 100 (maximum based on window size - 774,200)
 	global.clusters = 5; //set default number of clusters to create
-	initializeVector(); //initialize the coordinate vectors
+	global.hullMethod = HULL_QUICK; //use quick hull by default
+	global.threads = 1; //use a single threaded hull by default
+	global.hullFilter = HULL_FILTER_NONE; //hull every point by default
 
 	glutInit(&argc, argv);
+
+	//seed the random number generator from the command line if a seed was given, so a run can be repeated, otherwise from the time
+	global.seed = argc > 1 ? strtoull(argv[1], NULL, 10) : static_cast <unsigned long long> (time(0));
+	rng_seed(global.generator, global.seed);
+	cout << "Seed: " << global.seed << endl;
+	initializeSampler(); //initialize the coordinate sampler
+
 	glutInitDisplayMode(GLUT_RGB | GLUT_SINGLE);
 
 	glutInitWindowSize(global.w, global.h);
-	glutCreateWindow("2D Hull Peeler");
+	glutCreateWindow(WINDOW_TITLE);
+	init_buffers(); //look up the buffer object functions, now that there is an opengl context
 	glShadeModel(GL_SMOOTH);
 	glutKeyboardFunc(keyboard);
 	glMatrixMode(GL_PROJECTION);
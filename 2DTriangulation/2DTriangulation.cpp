@@ -1,10 +1,15 @@
-/* This is an implementation of a 2D triangulation, using the trisection triangulation algorithm and triangulation cleanup algorithm.
+/* This is an implementation of a 2D triangulation, using a sweep hull delaunay triangulation and triangulation cleanup algorithm.
 * This allows the user to create either random points, mouse drawn points, or a lattice of points (not fully implemented).
 * The random set is of 10 points, with incrementation by 10 possible as well. The lattice is NxN, with N starting at 10 as well.
-* The triangulation first does a convex hull then finds the centre point.
-* After this, the triangulation tries to create all the triangles from points interior to the convex hull.
+* The triangulation sorts the points, then adds them one at a time, joining each one to the part of the hull it can see.
+* After each point is added, edges are flipped until every triangle is delaunay (no other point is inside its circle).
 * Then the triangles are cleaned up using the triangle cleanup algorithm.
 * After triangulation, the number of triangles cleaned up, the number of points, and number of triangles are printed to the console.
+* Once the points are triangulated, points added with the mouse or by adding 10 points are inserted into the triangulation, instead of starting over.
+* The random points come from a seeded sampler, the seed is printed at startup and can be given as the first argument to repeat a run.
+* The triangulation runs on a background job so the window stays responsive, with its progress shown in the title, and X cancels it.
+* K switches the triangulation to a constrained one, keeping the hull layers of the points (from a peel) as edges,
+* and then to one that also drops every other band between the layers as a hole. A constrained mesh can't be cleaned up or take new points.
 */
 
 #include <stdlib.h>
@@ -16,25 +21,43 @@
 #include <iostream>
 #include <vector>
 #include <algorithm>
+#include <string>
+#include <functional>
+#include <atomic>
+#include "../Geometry/halfedge.h"
+#include "../Geometry/triangulation.h"
+#include "../Geometry/hull.h"
+#include "../Geometry/sample.h"
+#include "../Geometry/job.h"
+#include "../Geometry/prep.h"
 using namespace std;
 
-//the point structure
-typedef struct
-{
-	int x, y; //x and y coordinates within the window
-} point;
-
-//the edge structure
-typedef struct
-{
-	point p1, p2; //the two points making up an edge
-} edge;
+//the opengl buffer object constants and functions, which came after opengl 1.1 so they are looked up at runtime (see init_buffers)
+#ifndef GL_ARRAY_BUFFER
+#define GL_ARRAY_BUFFER 0x8892
+#define GL_ELEMENT_ARRAY_BUFFER 0x8893
+#define GL_STATIC_DRAW 0x88E4
+#endif
+typedef void (APIENTRY *gen_buffers_fn)(GLsizei n, GLuint* buffers);
+typedef void (APIENTRY *bind_buffer_fn)(GLenum target, GLuint buffer);
+typedef void (APIENTRY *buffer_data_fn)(GLenum target, ptrdiff_t size, const void* data, GLenum usage);
+
+//enums for the buffers the window is drawn from
+enum {
+	BUFFER_POINTS, BUFFER_VERTICES, BUFFER_EDGES, BUFFER_COUNT
+};
 
-//the triangle structure
+//the draw buffers structure, holding the points and edges as they were last uploaded, so a frame is drawn with a few calls instead of one for each vertex
 typedef struct
 {
-	point p1, p2, p3; //the three points making up a triangle
-} tri;
+	bool stale; //true when the points or mesh may have changed since they were last uploaded
+	GLuint names[BUFFER_COUNT]; //the buffer objects for the points, the mesh vertices and the edges
+	vector<GLuint> edges; //the two vertices of every edge, as indices into the mesh vertices
+	GLsizei pointCount, edgeCount; //the number of points and edge indices uploaded
+	gen_buffers_fn genBuffers; //the buffer object functions, NULL when opengl doesn't have them, in which case the arrays are drawn from memory
+	bind_buffer_fn bindBuffer;
+	buffer_data_fn bufferData;
+} draw_buffers;
 
 //the global structure
 typedef struct
@@ -42,655 +65,495 @@ typedef struct
 	int w, h; //w for width and h for height of the window
 	int n; //number of points to create
 	vector<point> points; //vector of points
-	vector<point> coords; //vector for all possible coordinates
-	vector<edge> edges; //vector of edges
-	vector<tri> tris; //vector of triangles
+	point_keys keys; //the keys of the points, for rejecting a duplicate mouse point in O(1), cleared whenever the points are replaced
+	sampler sample; //the sampler drawing random points from all possible coordinates
+	rng generator; //the random number generator seeding each new sample
+	unsigned long long seed; //the seed of the random number generator, printed so a run can be repeated
+	halfedge_mesh mesh; //the mesh of triangles
+	int insertFace; //the triangle touching the last point inserted into the mesh, where the search for the next one starts
 	bool mouseDraw; //true when drawing points with the mouse
-	bool shuffled; //true when the coords vector has been shuffled
+	bool sampled; //true when the points have been drawn from the sampler
+	int cleanupMethod; //the criterion used by tri_cleanup, either CLEANUP_DELAUNAY or CLEANUP_SHORTER
+	int constrainMode; //what the triangulation keeps the hull layers as, one of the CONSTRAIN enums
+	bool constrained; //true when the mesh is a constrained triangulation, which flips and insertions would break
+	draw_buffers buffers; //the points and edges uploaded for drawing
+	job work; //the background job, running a triangulation off the window thread so the window stays responsive
+	vector<point> jobPoints; //the points the job triangulates, copied when it starts
+	halfedge_mesh jobMesh; //the mesh the job triangulates the points in, only touched by the job until it has been collected
+	int jobFlips; //the number of flips made by the cleanup after the triangulation
+	bool jobConstrained; //true when the job makes a constrained triangulation
+	atomic<int> jobStage; //what the job is doing, one of the STAGE enums, moved on by the job itself between the stages of a constrained triangulation
 } glob;
 glob global;
 
 //enums for the menu buttons/options
 enum {
-	MENU_QUIT, MENU_RANDOM, MENU_TRIANGULATION, MENU_LATTICE, MENU_INCREMENT, MENU_MOUSE
+	MENU_QUIT, MENU_RANDOM, MENU_TRIANGULATION, MENU_LATTICE, MENU_INCREMENT, MENU_MOUSE, MENU_CLEANUP, MENU_CLEANUP_METHOD, MENU_CONSTRAIN, MENU_CANCEL
 };
 
-//this method creates a set of random points within the bounds of the window
-//the point and edge vectors are cleared to ensure the new points are added to an empty vector
-void random()
-{
-	vector<point>().swap(global.points); //clear the points vector, getting rid of its contents and freeing some memory
-	vector<edge>().swap(global.edges); //clear the edges vector, getting rid of its contents and freeing some memory
-	vector<tri>().swap(global.tris); //clear the tris vector, getting rid of its contents and freeing some memory
-	random_shuffle(global.coords.begin(), global.coords.end()); //shuffle the coordinate vector
+//enums for the constraints of the triangulation: none, the hull layers as edges, or the hull layers with every other band between them as a hole
+enum {
+	CONSTRAIN_NONE, CONSTRAIN_LAYERS, CONSTRAIN_HOLES
+};
 
-	//we have shuffled, so set the shuffle bool to true if it isn't already
-	if (!global.shuffled)
-		global.shuffled = true;
+//the names of the constraint modes, in the same order as the CONSTRAIN enums
+const char* constrainNames[] = { "no constraints", "hull layers", "hull layers with holes" };
 
-	//create 'n' random points from the vector of possible points based on the window size
-	for (int i = 0; i < global.n; i++)
-		global.points.push_back(point{ global.coords[i].x, global.coords[i].y }); //add the new point to the point vector
+//enums for the stages of the background job: a triangulation, or the peel and then the constrained triangulation of the layers
+enum {
+	STAGE_TRIANGULATE, STAGE_PEEL, STAGE_CONSTRAIN
+};
 
-	glutPostRedisplay(); //redisplay the window
-}
+//what each stage of the job is shown as in the window title, and what the steps it counts in the progress are, in the same order as the STAGE enums
+const char* stageNames[] = { "triangulating", "peeling", "constraining" };
+const char* stageSteps[] = { "triangles", "layers", "triangles and edges" };
 
-//this method creates a lattice of points of size N by N
-void lattice()
-{
-	vector<point>().swap(global.points); //clear the points vector, getting rid of its contents and freeing some memory
-	vector<edge>().swap(global.edges); //clear the edges vector, getting rid of its contents and freeing some memory
-	vector<tri>().swap(global.tris); //clear the tris vector, getting rid of its contents and freeing some memory
+//the title of the window, which shows the progress of the background job after it while one is running
+const char WINDOW_TITLE[] = "2D Triangulation";
 
-	//create a N by N lattice
-	for (int i = 0; i < global.n; i++)
-		for (int j = 0; j < global.n; j++)
-			global.points.push_back(point{ i * 5, j * 5 }); //add the new point to the point vector
-
-	glutPostRedisplay(); //redisplay the window
-}
+//the time between checks on a running job, in milliseconds
+const int JOB_POLL_MS = 100;
 
-//create a point where the mouse clicks
-//this method ensures that each point is unique and places the points correctly based on the mouse position in the window
-//the y value has to be essentially inversed as 0 in the window is bottom left and 0 for the mouse position is top left
-void draw_mouse_point(int x, int y)
+//this method checks if the background job is running, letting the user know it has to finish or be cancelled first
+//anything that changes the points or mesh waits for the job, as they are replaced with what it made once it is collected
+bool job_busy()
 {
-	y = global.h - 10 - y; //subtract the value of y from the max y coordinate
-
-	//ensure the point is unique from all other points
-	for (const point& p : global.points)
-		if (p.x == x && p.y == y)
-			return;
-
-	global.points.push_back(point{ x, y }); //add the point to the global points vector
-	vector<edge>().swap(global.edges); //clear the edges vector, getting rid of its contents and freeing some memory
-	vector<tri>().swap(global.tris); //clear the tris vector, getting rid of its contents and freeing some memory
+	if (!job_running(global.work))
+		return false;
 
-	glutPostRedisplay(); //redisplay the window
+	cout << "Still working, wait for the job to finish or press X to cancel it." << endl;
+	return true;
 }
 
-//this method is called whenever opengl calls the mouse fun
-//it calls the draw_mouse_point when the user is creating points with the mouse and has left clicked somewhere in the window
-void mouse(int bin, int state, int x, int y)
+//this method uses the results of the background job once it has been collected, replacing the global mesh with the triangulation it made
+//nothing is replaced if the job was cancelled
+void finish_job()
 {
-	if (global.mouseDraw && bin == GLUT_LEFT_BUTTON && state == GLUT_DOWN) draw_mouse_point(x, y);
-}
+	glutSetWindowTitle(WINDOW_TITLE);
 
-//this method is an implementation of the QuickHull algorithm
-//the coefficients to calculated the distance are calculated first
-//points for the max and direction vectors are created, and the ints for distance are initialized
-//then all points are iterated through, finding the point with the max distance from the line
-//if no point is found, that means either all points are interior to the line or there are colinear points
-//that means that the edge is added to the global edge vector
-//if a point is found, quick_hull is called on the two lines from pMax to the original two points
-void quick_hull(point p1, point p2)
-{
-	//set the coefficients
-	int a = p1.y - p2.y;
-	int b = p2.x - p1.x;
-	int c = p1.x * p2.y - p1.y * p2.x;
-
-	//initalize the points and ints
-	point pMax = point{ 0, 0 };
-	int maxD = 0;
-	int d;
-	point dir_p1_p, dir_p_p2;
-
-	//iterate through all points, finding the max distance points
-	for (const point& p : global.points)
+	if (global.work.progress.cancel)
+		cout << "Job cancelled." << endl;
+	else
 	{
-		if (!(p.x == p1.x && p.y == p1.y || p.x == p2.x && p.y == p2.y))
-		{
-			d = a * p.x + b * p.y + c;
-
-			if (d > maxD)
-			{
-				pMax = p;
-				maxD = d;
-			}
-		}
+		swap(global.mesh, global.jobMesh);
+		global.constrained = global.jobConstrained;
+		global.points.clear(); //empty the points vector, keeping its memory for the next points
+		keys_clear(global.keys);
+
+		if (!global.constrained)
+			cout << "Triangles cleaned up: " << global.jobFlips << endl;
+		cout << "Number of points: " << global.mesh.points.size() << endl;
+		cout << "Number of triangles created: " << he_face_count(global.mesh) << endl;
 	}
 
-	//if no point is found, add the edge to the vector
-	if (maxD == 0)
+	//empty the copies the job worked on, keeping their memory for the next job, which triangulates into the old mesh
+	global.jobPoints.clear();
+	he_reset(global.jobMesh);
+	global.buffers.stale = true;
+	glutPostRedisplay();
+}
+
+//this method checks on the background job every JOB_POLL_MS, showing its progress in the window title until it can be collected
+void poll_job(int value)
+{
+	if (job_collect(global.work))
 	{
-		global.edges.push_back(edge{ p1, p2 });
+		finish_job();
 		return;
 	}
 
-	//recursively call quick_hull
-	quick_hull(p1, pMax);
-	quick_hull(pMax, p2);
+	int stage = global.jobStage.load();
+	string title = string(WINDOW_TITLE) + " - " + stageNames[stage] + ": " + to_string(global.work.progress.done.load()) + " " + stageSteps[stage] + " (X to cancel)";
+	glutSetWindowTitle(title.c_str());
+	glutTimerFunc(JOB_POLL_MS, poll_job, 0);
 }
 
-//this method creates a convex hull using the quick hull algorithm
-//the method finds the point with the minimum x and maximum x values
-//then, quick_hull is called for both directions of the line, ensuring we create a top and bottom to the hull
-void convex_hull()
+//this method starts the background job, running work on a copy of the global points
+//the window keeps drawing the points and mesh as they were until poll_job collects the job
+void start_job(const function<void(job_progress&)>& work)
 {
-	//if there are less than three points, we cannot create a convex hull so immediately stop
-	if (global.points.size() < 3)
-		return;
-
-	//initialize the min and max points
-	point minPoint;
-	minPoint.x = global.w;
-	point maxPoint;
-	maxPoint.x = -1;
+	global.jobPoints = global.points;
+	job_start(global.work, work);
+	glutTimerFunc(JOB_POLL_MS, poll_job, 0);
+}
 
-	//iterate through all points and find the min and max
-	for (const point& p : global.points)
-	{
-		if (p.x < minPoint.x)
-			minPoint = p;
-		if (p.x > maxPoint.x)
-			maxPoint = p;
-	}
+//this method cancels the background job, which poll_job collects once it has stopped
+void cancel_job()
+{
+	if (!job_running(global.work))
+		return;
 
-	//call quick hull for both directions of the line
-	quick_hull(minPoint, maxPoint);
-	quick_hull(maxPoint, minPoint);
+	job_cancel(global.work);
+	cout << "Cancelling..." << endl;
 }
 
-//this method checks if a given point exists within the global vector of edges
-//returns true when the point is on an edge and false otherwise
-bool on_edge(point p)
+//this method quits the program, stopping the background job first
+void quit()
 {
-	for (const edge& e : global.edges)
-		if ((p.x == e.p1.x && p.y == e.p1.y) || (p.x == e.p2.x && p.y == e.p2.y))
-			return true;
-
-	return false;
+	job_cancel(global.work);
+	job_wait(global.work);
+	exit(0);
 }
 
-//this method returns the distance between two points using pythagorean theorem
-int pythagorean(point p1, point p2)
+//initialize the sampler for coordinates, with a new seed from the random number generator
+void initializeSampler()
 {
-	return sqrt((p2.x - p1.x) * (p2.x - p1.x) + (p2.y - p1.y) * (p2.y - p1.y));
+	//the sampler covers all possible combinations of x and y (making sure points are only drawn within the visual bounds of the screen!)
+	sampler_init(global.sample, 1, 1, global.w - 10, global.h - 10, rng_next(global.generator));
 }
 
-//this method calculates and returns the distance of point p3 from the line p1p2
-int dist(point p1, point p2, point p3)
+//this method creates a set of random points within the bounds of the window
+//the point vector and mesh are cleared to ensure the new points are added to an empty vector
+void random()
 {
-	int d = 0; //initialize the distance int
+	if (job_busy())
+		return;
+
+	global.points.clear(); //empty the points vector, keeping its memory for the new points
+	keys_clear(global.keys);
+	he_reset(global.mesh); //empty the mesh, keeping its memory for the next one
+	initializeSampler(); //start a new sample, so the points come in a new order
 
-	d += (p1.y - p2.y) * p3.x; //add the 'A' coefficient to the distance where A = (y1 - y2)
-	d += (p2.x - p1.x) * p3.y; //add the 'B' coefficient to the distance where B = (x2 - x1)
-	d += p1.x * p2.y - p1.y * p2.x; //add the 'C' coefficient to the distance where C = (x1y2 - y1x2)
+	//we have sampled, so set the sample bool to true if it isn't already
+	if (!global.sampled)
+		global.sampled = true;
 
-	return d;
+	//draw 'n' random points from the possible points based on the window size
+	sampler_take(global.sample, global.n, global.points);
+
+	glutPostRedisplay(); //redisplay the window
 }
 
-//check if the given point is within the given triangle
-//returns true when the point is within, false otherwise
-//if the point is colinear, it returns false
-bool point_in_triangle(point p, tri t)
+//this method creates a lattice of points of size N by N
+void lattice()
 {
-	//calculate the distances
-	int d1 = dist(t.p1, t.p2, p);
-	int d2 = dist(t.p2, t.p3, p);
+	if (job_busy())
+		return;
 
-	//if the distances signs don't match, the point is not in the triangle
-	if ((d1 > 0 && d2 < 0) || (d1 < 0 && d2 > 0))
-		return false;
+	global.points.clear(); //empty the points vector, keeping its memory for the new points
+	keys_clear(global.keys);
+	he_reset(global.mesh); //empty the mesh, keeping its memory for the next one
 
-	//calculate the third distance
-	int d3 = dist(t.p3, t.p1, p);
+	//create a N by N lattice
+	for (int i = 0; i < global.n; i++)
+		for (int j = 0; j < global.n; j++)
+			global.points.push_back(point{ i * 5, j * 5 }); //add the new point to the point vector
+
+	glutPostRedisplay(); //redisplay the window
+}
 
-	//if the distances signs don't match, the point is not in the triangle
-	if ((d1 > 0 && d3 < 0) || (d1 < 0 && d3 > 0))
+//this method checks if the global mesh is a constrained triangulation, letting the user know it has to be triangulated again first
+//the insertions and the cleanup flip edges without knowing about the constraints, so they are not run on a constrained mesh
+bool mesh_constrained()
+{
+	if (!global.constrained || he_face_count(global.mesh) == 0)
 		return false;
 
-	//otherwise the point must be within the triangle or is colinear
+	cout << "The mesh is constrained, make new points and triangulate them again to change it." << endl;
 	return true;
 }
 
-//this method trisects a triangle to find if there are any points interior to it to create more triangles
-//after finding the extents, all points are iterated through, finding which points are within the triange
-//if the point is within the given triangle, then trisect the three triangles formed by that point
-void trisect(tri t)
+//this method inserts the points into the triangulation in the global mesh with tri_insert, one at a time
+//each insertion only flips the edges near the new point, so this is far quicker than triangulating every point again
+//the number of points inserted is printed to the console, leaving out any that were already in the mesh
+void insert_points(const vector<point>& points)
 {
-	//determine the extents of the triangle by finding the min and max for the x and y coordinates
-	int xMax = -1, xMin = global.w, yMax = -1, yMin = global.h;
-
-	xMax = max(t.p1.x, xMax);
-	xMax = max(t.p2.x, xMax);
-	xMax = max(t.p3.x, xMax);
+	int inserted = 0;
+	for (const point& p : points)
+		if (tri_insert(global.mesh, p, global.insertFace))
+			inserted++;
 
-	yMax = max(t.p1.y, yMax);
-	yMax = max(t.p2.y, yMax);
-	yMax = max(t.p3.y, yMax);
+	cout << "Points inserted: " << inserted << ", number of triangles: " << he_face_count(global.mesh) << endl;
+}
 
-	xMin = min(t.p1.x, xMin);
-	xMin = min(t.p2.x, xMin);
-	xMin = min(t.p3.x, xMin);
+//create a point where the mouse clicks
+//this method ensures that each point is unique and places the points correctly based on the mouse position in the window
+//the y value has to be essentially inversed as 0 in the window is bottom left and 0 for the mouse position is top left
+void draw_mouse_point(int x, int y)
+{
+	if (job_busy())
+		return;
 
-	yMin = min(t.p1.y, yMin);
-	yMin = min(t.p2.y, yMin);
-	yMin = min(t.p3.y, yMin);
+	y = global.h - 10 - y; //subtract the value of y from the max y coordinate
 
-	bool pFound = false;
+	//ensure the point is unique from all other points, looking it up in the keys of the points rather than scanning them
+	keys_sync(global.keys, global.points);
+	if (keys_has(global.keys, point{ x, y }))
+		return;
 
-	//go through all points, but check if the point is interior to the triangle before doing any trisections
-	for (const point& p : global.points)
+	//if the points have been triangulated, insert the new point into the triangulation
+	if (mesh_constrained())
+		return;
+	if (he_face_count(global.mesh) > 0)
 	{
-		//ensure the point is not one of the three making up this triangle
-		if (!((p.x == t.p1.x && p.y == t.p1.y) || (p.x == t.p2.x && p.y == t.p2.y) || (p.x == t.p3.x && p.y == t.p3.y)))
-		{
-			//if the point is within the extents of the triangle, determine if it is interior to the triangle
-			if (p.x >= xMin && p.x <= xMax && p.y >= yMin && p.y <= yMax)
-			{
-				//if the point is within the triangle, call trisect on the three triangles making it up
-				//set pFound to true to ensure the encompassing triangle is not added to the global tris vector
-				if (point_in_triangle(p, t))
-				{
-					pFound = true;
-					trisect(tri{ t.p1, t.p2, p });
-					trisect(tri{ t.p2, t.p3, p });
-					trisect(tri{ t.p3, t.p1, p });
-				}
-			}
-		}
+		insert_points(vector<point>{ point{ x, y } });
+		glutPostRedisplay(); //redisplay the window
+		return;
 	}
 
-	//if we find no interior point, add the triangle to global tri vector
-	if (!pFound)
-		global.tris.push_back(t);
+	global.points.push_back(point{ x, y }); //add the point to the global points vector
+	he_reset(global.mesh); //empty the mesh, keeping its memory for the next one
+
+	glutPostRedisplay(); //redisplay the window
+}
+
+//this method is called whenever opengl calls the mouse fun
+//it calls the draw_mouse_point when the user is creating points with the mouse and has left clicked somewhere in the window
+void mouse(int bin, int state, int x, int y)
+{
+	if (global.mouseDraw && bin == GLUT_LEFT_BUTTON && state == GLUT_DOWN)
+	{
+		global.buffers.stale = true; //the point may be added, so upload the points again on the next draw
+		draw_mouse_point(x, y);
+	}
 }
 
-//this method checks the two passed in ints to determine if they have the same sign or not
-bool same_sign(int a, int b)
+//this method cleans up the triangles in the global mesh with tri_cleanup, using the criterion set by global.cleanupMethod
+//the number of flips made is printed to the console and returned
+int cleanup()
 {
-	if (a >= 0 && b >= 0)
-		return true;
-	if (a <= 0 && b <= 0)
-		return true;
+	if (job_busy() || mesh_constrained())
+		return 0;
+
+	int trisCleaned = tri_cleanup(global.mesh, global.cleanupMethod);
 
-	return false;
+	glutPostRedisplay();
+
+	cout << "Triangles cleaned up: " << trisCleaned << endl;
+	return trisCleaned;
 }
 
-//this method checks all possible edges of the two triangles to determine if they share an edge
-//if a shared edge is found, we can immediately return as two triangles can only ever share one edge (otherwise one of them wouldn't be a triangle)
-//this method sets the two given tris to the calculated tris if a shared edge is found
-bool check_shared_edge(tri& t1, tri& t2)
+//this method switches the criterion used by tri_cleanup between the circle test and the shorter diagonal
+void switch_cleanup_method()
 {
-	//initialize ints for keeping track of distance and point count, and bools for keeping track of shared points
-	int d1, d2, pointCount = 0;
-	bool t1p1Share = false, t1p2Share = false, t1p3Share = false;
-	bool t2p1Share = false, t2p2Share = false, t2p3Share = false;
+	global.cleanupMethod = global.cleanupMethod == CLEANUP_DELAUNAY ? CLEANUP_SHORTER : CLEANUP_DELAUNAY;
+	cout << "Cleanup method set to " << (global.cleanupMethod == CLEANUP_SHORTER ? "shorter diagonal" : "delaunay") << endl;
+}
 
-	//check if tri 1's p1 is the same as any point in tri 2, then check t1.p2 and t1.p3
-	if ((t1.p1.x == t2.p1.x && t1.p1.y == t2.p1.y) || (t1.p1.x == t2.p2.x && t1.p1.y == t2.p2.y) || (t1.p1.x == t2.p3.x && t1.p1.y == t2.p3.y))
-	{
-		pointCount++;
-		t1p1Share = true;
-
-		//determine which point t1.p1 shares with t2
-		if (t1.p1.x == t2.p1.x && t1.p1.x == t2.p1.y)
-			t2p1Share = true;
-		else if (t1.p1.x == t2.p2.x && t1.p1.x == t2.p2.y)
-			t2p2Share = true;
-		else
-			t2p3Share = true;
-	}
-	if ((t1.p2.x == t2.p1.x && t1.p2.y == t2.p1.y) || (t1.p2.x == t2.p2.x && t1.p2.y == t2.p2.y) || (t1.p2.x == t2.p3.x && t1.p2.y == t2.p3.y))
-	{
-		pointCount++;
-		t1p2Share = true;
-
-		//determine which point t1.p2 shares with t2
-		if (t1.p2.x == t2.p1.x && t1.p2.x == t2.p1.y)
-			t2p1Share = true;
-		else if (t1.p2.x == t2.p2.x && t1.p2.x == t2.p2.y)
-			t2p2Share = true;
-		else
-			t2p3Share = true;
-	}
-	if (pointCount == 1 && ((t1.p3.x == t2.p1.x && t1.p3.y == t2.p1.y) || (t1.p3.x == t2.p2.x && t1.p3.y == t2.p2.y) || (t1.p3.x == t2.p3.x && t1.p3.y == t2.p3.y)))
-	{
-		pointCount++;
-		t1p3Share = true;
-
-		//determine which point t1.p3 shares with t2
-		if (t1.p3.x == t2.p1.x && t1.p3.x == t2.p1.y)
-			t2p1Share = true;
-		else if (t1.p3.x == t2.p2.x && t1.p3.x == t2.p2.y)
-			t2p2Share = true;
-		else
-			t2p3Share = true;
-	}
+//this method switches the constraints of the triangulation between none, the hull layers, and the hull layers with holes
+void switch_constraints()
+{
+	global.constrainMode = (global.constrainMode + 1) % 3;
+	cout << "Triangulation constraints set to " << constrainNames[global.constrainMode] << endl;
+}
+
+//this method performs a triangulation of all points in the global points vector, on the background job
+//a delaunay triangulation of the points is created, counting each triangle made in the progress, then its triangles are cleaned up
+//with constraints, the points are peeled instead, counting each layer in the progress, then triangulated keeping the layers as edges, with no cleanup,
+//which counts each triangle made and then each layer edge put in from zero again, so the window title can say which stage the steps are from
+//once the job is collected, the triangulation replaces the global mesh and the number of points and triangles are printed to the console
+void triangulation()
+{
+	if (job_busy() || global.points.size() < 3)
+		return;
 
-	//if exactly two points are shared, we know there is a shared edge, thus find the two new triangles to create
-	if (pointCount == 2)
+	int method = global.cleanupMethod, mode = global.constrainMode;
+	global.jobConstrained = mode != CONSTRAIN_NONE;
+	global.jobFlips = 0;
+	global.jobStage = mode == CONSTRAIN_NONE ? STAGE_TRIANGULATE : STAGE_PEEL;
+	start_job([method, mode](job_progress& progress)
 	{
-		//calculate the distance between points to find the length of the edges to determine which edge is best
-		//if tri 1's shared edge is (p1,p2)
-		if (t1p1Share && t1p2Share)
+		if (mode == CONSTRAIN_NONE)
 		{
-			d1 = pythagorean(t1.p1, t1.p2);
-			//if tri 2's shared is (p1,p2)
-			if (t2p1Share && t2p2Share)
-			{
-				//if the points making up the edge are on the same side of the new edge, we don't have a better edge
-				if (same_sign(dist(t1.p3, t2.p3, t1.p1), dist(t1.p3, t2.p3, t1.p2)))
-					return false;
-
-				d2 = pythagorean(t1.p3, t2.p3);
-
-				if (abs(d2) < abs(d1))
-				{
-					tri temp = tri{ t1.p1, t1.p2, t1.p3 };
-					t1 = tri{t1.p1, t1.p3, t2.p3};
-					t2 = tri{temp.p2, temp.p3, t2.p3};
-					return true;
-				}
-			}
-			//elif tri 2's shared edge is (p1,p3)
-			else if (t2p1Share && t2p3Share)
-			{
-				//if the points making up the edge are on the same side of the new edge, we don't have a better edge
-				if (same_sign(dist(t1.p3, t2.p2, t1.p1), dist(t1.p3, t2.p2, t1.p2)))
-					return false;
-
-				d2 = pythagorean(t1.p3, t2.p2);
-
-				if (abs(d2) < abs(d1))
-				{
-					tri temp = tri{ t1.p1, t1.p2, t1.p3 };
-					t1 = tri{ t1.p1, t1.p3, t2.p2 };
-					t2 = tri{ temp.p2, temp.p3, t2.p2 };
-					return true;
-				}
-			}
-			//else tri 2's shared edge is (p2,p3)
-			else
-			{
-				//if the points making up the edge are on the same side of the new edge, we don't have a better edge
-				if (same_sign(dist(t1.p3, t2.p1, t1.p1), dist(t1.p3, t2.p1, t1.p2)))
-					return false;
-
-				d2 = pythagorean(t1.p3, t2.p1);
-
-				if (abs(d2) < abs(d1))
-				{
-					tri temp = tri{ t1.p1, t1.p2, t1.p3 };
-					t1 = tri{ t1.p1, t1.p3, t2.p1 };
-					t2 = tri{ temp.p2, temp.p3, t2.p1 };
-					return true;
-				}
-			}
-		}
-		//elif tri 1's shared edge is (p1,p3)
-		else if (t1p1Share && t1p3Share)
-		{
-			d1 = pythagorean(t1.p1, t1.p3);
-			//if tri 2's shared is (p1,p2)
-			if (t2p1Share && t2p2Share)
-			{
-				//if the points making up the edge are on the same side of the new edge, we don't have a better edge
-				if (same_sign(dist(t1.p2, t2.p3, t1.p1), dist(t1.p2, t2.p3, t1.p3)))
-					return false;
-
-				d2 = pythagorean(t1.p2, t2.p3);
-
-				if (abs(d2) < abs(d1))
-				{
-					tri temp = tri{ t1.p1, t1.p2, t1.p3 };
-					t1 = tri{ t1.p1, t1.p2, t2.p3 };
-					t2 = tri{ temp.p3, temp.p2, t2.p3 };
-					return true;
-				}
-			}
-			//elif tri 2's shared edge is (p1,p3)
-			else if (t2p1Share && t2p3Share)
-			{
-				//if the points making up the edge are on the same side of the new edge, we don't have a better edge
-				if (same_sign(dist(t1.p2, t2.p2, t1.p1), dist(t1.p2, t2.p2, t1.p3)))
-					return false;
-
-				d2 = pythagorean(t1.p2, t2.p2);
-
-				if (abs(d2) < abs(d1))
-				{
-					tri temp = tri{ t1.p1, t1.p2, t1.p3 };
-					t1 = tri{ t1.p1, t1.p2, t2.p2 };
-					t2 = tri{ temp.p3, temp.p2, t2.p2 };
-					return true;
-				}
-			}
-			//else tri 2's shared edge is (p2,p3)
-			else
-			{
-				//if the points making up the edge are on the same side of the new edge, we don't have a better edge
-				if (same_sign(dist(t1.p2, t2.p1, t1.p1), dist(t1.p2, t2.p1, t1.p3)))
-					return false;
-
-				d2 = pythagorean(t1.p2, t2.p1);
-
-				if (abs(d2) < abs(d1))
-				{
-					tri temp = tri{ t1.p1, t1.p2, t1.p3 };
-					t1 = tri{ t1.p1, t1.p2, t2.p1 };
-					t2 = tri{ temp.p3, temp.p2, t2.p1 };
-					return true;
-				}
-			}
-		}
-		//else tri 1's shared edge is (p2,p3)
-		else
-		{
-			d1 = pythagorean(t1.p2, t1.p3);
-			//if tri 2's shared is (p1,p2)
-			if (t2p1Share && t2p2Share)
-			{
-				//if the points making up the edge are on the same side of the new edge, we don't have a better edge
-				if (same_sign(dist(t1.p1, t2.p3, t1.p2), dist(t1.p1, t2.p3, t1.p3)))
-					return false;
-
-				d2 = pythagorean(t1.p1, t2.p3);
-
-				if (abs(d2) < abs(d1))
-				{
-					tri temp = tri{ t1.p1, t1.p2, t1.p3 };
-					t1 = tri{ t1.p2, t1.p1, t2.p3 };
-					t2 = tri{ temp.p3, temp.p1, t2.p3 };
-					return true;
-				}
-			}
-			//elif tri 2's shared edge is (p1,p3)
-			else if (t2p1Share && t2p3Share)
-			{
-				//if the points making up the edge are on the same side of the new edge, we don't have a better edge
-				if (same_sign(dist(t1.p1, t2.p2, t1.p2), dist(t1.p1, t2.p2, t1.p3)))
-					return false;
-
-				d2 = pythagorean(t1.p1, t2.p2);
-
-				if (abs(d2) < abs(d1))
-				{
-					tri temp = tri{ t1.p1, t1.p2, t1.p3 };
-					t1 = tri{ t1.p2, t1.p1, t2.p2 };
-					t2 = tri{ temp.p3, temp.p1, t2.p2 };
-					return true;
-				}
-			}
-			//else tri 2's shared edge is (p2,p3)
-			else
-			{
-				//if the points making up the edge are on the same side of the new edge, we don't have a better edge
-				if (same_sign(dist(t1.p1, t2.p1, t1.p2), dist(t1.p1, t2.p1, t1.p3)))
-					return false;
-
-				d2 = pythagorean(t1.p1, t2.p1);
-
-				if (abs(d2) < abs(d1))
-				{
-					tri temp = tri{ t1.p1, t1.p2, t1.p3 };
-					t1 = tri{ t1.p2, t1.p1, t2.p1 };
-					t2 = tri{ temp.p3, temp.p1, t2.p1 };
-					return true;
-				}
-			}
+			if (delaunay(global.jobPoints, global.jobMesh, progress)) //triangulate the points
+				global.jobFlips = tri_cleanup(global.jobMesh, method); //clean up the triangles
+			return;
 		}
-	}
 
-	//otherwise the two triangles do not share an edge
-	return false;
+		//peel the points, then triangulate them keeping the layers
+		vector<vector<int>> layers;
+		hull_scratch scratch;
+		tri_constraints constraints;
+		if (!peel_layers(global.jobPoints, layers, scratch, progress))
+			return;
+
+		progress.done = 0;
+		global.jobStage = STAGE_CONSTRAIN;
+		constrained_delaunay(global.jobPoints, layers, mode == CONSTRAIN_HOLES, global.jobMesh, constraints, progress);
+	});
 }
 
-//this method implements a triangle cleanup algorithm to attempt to reduce the line lengths of shared edges
-void tri_cleanup()
+//this method looks up the buffer object functions, once there is an opengl context, and creates the buffers
+//buffer objects need opengl 1.5, without it the functions are left NULL and the points and edges are drawn from memory as vertex arrays
+void init_buffers()
 {
-	int trisCleaned = 0;
+	draw_buffers& b = global.buffers;
+	b.stale = true;
+
+	int major = 0, minor = 0;
+	const char* version = (const char*)glGetString(GL_VERSION);
+	if (version == NULL || sscanf(version, "%d.%d", &major, &minor) != 2 || major * 10 + minor < 15)
+		return;
 
-	//iterate through all tris
-	for (tri t1 : global.tris)
+	b.genBuffers = (gen_buffers_fn)glutGetProcAddress("glGenBuffers");
+	b.bindBuffer = (bind_buffer_fn)glutGetProcAddress("glBindBuffer");
+	b.bufferData = (buffer_data_fn)glutGetProcAddress("glBufferData");
+	if (b.genBuffers == NULL || b.bindBuffer == NULL || b.bufferData == NULL)
 	{
-		//then, iterate through all tris and compare the top level tri to the lower level tri
-		for (tri t2 : global.tris)
-		{
-			//if the two tris share an edge, replace them with better tris
-			if (check_shared_edge(t1, t2))
-			{
-				trisCleaned++;
-				glutPostRedisplay();
-			}
-		}
+		b.genBuffers = NULL;
+		b.bindBuffer = NULL;
+		b.bufferData = NULL;
+		return;
 	}
 
-	cout << "Triangles cleaned up: " << trisCleaned << endl;
+	b.genBuffers(BUFFER_COUNT, b.names);
 }
 
-//this method performs a triangulation of all points in the global points vector
-//first a convex hull is created, then a mid point is found (closest to centre of screen)
-//then each triangle formed from the convex hull to the mid point is trisected
-//then the number of points and triangles are printed to the console
-void triangulation()
+//this method copies size bytes of data into one of the buffers, when there are buffer objects
+void upload_buffer(GLenum target, int buffer, const void* data, size_t size)
 {
-	if (global.points.size() < 3)
+	draw_buffers& b = global.buffers;
+	if (b.bufferData == NULL)
 		return;
 
-	vector<tri>().swap(global.tris); //clear the tris vector, getting rid of its contents and freeing some memory
-	convex_hull(); //perform an initial convex hull to create the bounds of the set of points
+	b.bindBuffer(target, b.names[buffer]);
+	b.bufferData(target, (ptrdiff_t)size, data, GL_STATIC_DRAW);
+	b.bindBuffer(target, 0);
+}
 
-	//initialize variables for determining the middle most point in the window
-	point pMid;
-	int minD = INT_MAX;
-	int d;
+//this method uploads the global points, the mesh vertices and the mesh edges, which are then drawn from the buffers until they change again
+//every edge becomes a single line, from the half edge with the smaller index (or the only one, on the boundary)
+void upload_buffers()
+{
+	draw_buffers& b = global.buffers;
+	const halfedge_mesh& m = global.mesh;
 
-	//iterate through all points and find the point closest to the middle that is not on the edge
-	for (const point& p : global.points)
+	b.edges.clear();
+	for (int h = 0; h < m.origin.size(); h++)
 	{
-		if (!on_edge(p))
-		{
-			d = pythagorean(p, point{ global.w / 2, global.h / 2 }); //find distance between current point and centre of screen
-			if (d < minD) //if the distance is less than the current min distance, set it as the new min distance
-			{
-				pMid = p;
-				minD = d;
-			}
-		}
-	}
-
-	//if we find no interior point, use the first point from the convex hull
-	//doesn't currently ensure that the point is not colinear
-	if (minD == INT_MAX)
-		pMid = global.edges[0].p1;
+		if (m.twin[h] > h)
+			continue;
 
-	//for all edges, create a triangle to the calculated middle point and call trisect on it
-	for (const edge& e : global.edges)
-		trisect(tri{ e.p1, e.p2, pMid });
+		b.edges.push_back(m.origin[h]);
+		b.edges.push_back(he_target(m, h));
+	}
 
-	vector<point>().swap(global.points); //clear the points vector, getting rid of its contents and freeing some memory
-	vector<edge>().swap(global.edges); //clear the edges vector, getting rid of its contents and freeing some memory
-	glutPostRedisplay();
+	b.pointCount = (GLsizei)global.points.size();
+	b.edgeCount = (GLsizei)b.edges.size();
+	upload_buffer(GL_ARRAY_BUFFER, BUFFER_POINTS, global.points.data(), global.points.size() * sizeof(point));
+	upload_buffer(GL_ARRAY_BUFFER, BUFFER_VERTICES, m.points.data(), m.points.size() * sizeof(point));
+	upload_buffer(GL_ELEMENT_ARRAY_BUFFER, BUFFER_EDGES, b.edges.data(), b.edges.size() * sizeof(GLuint));
+	b.stale = false;
+}
 
-	tri_cleanup(); //clean up the triangles
+//this method binds one of the buffers to be drawn from, returning where its data starts for glVertexPointer or glDrawElements
+//that is offset 0 in the bound buffer object, or data itself when the arrays are drawn from memory
+const void* bind_buffer(GLenum target, int buffer, const void* data)
+{
+	draw_buffers& b = global.buffers;
+	if (b.bindBuffer == NULL)
+		return data;
 
-	cout << "Number of points: " << global.points.size() << endl;
-	cout << "Number of triangles created: " << global.tris.size() << endl;
+	b.bindBuffer(target, b.names[buffer]);
+	return NULL;
 }
 
 //this method draws the points and triangles to the window, showing the work done by the triangulation
+//the points and edges are only uploaded when they have changed, then each frame draws all the points with one call and all the triangle edges with another
 void draw()
 {
 	glClear(GL_COLOR_BUFFER_BIT); //make sure to clear the screen before drawing new points
 
+	draw_buffers& b = global.buffers;
+	if (b.stale)
+		upload_buffers();
+
 	glPointSize(3.0); //set the size of the points larger so they are easier to see
 	glColor3f(1.0, 1.0, 1.0); //set them to white
-
-	//begin drawing points on screen
-	glBegin(GL_POINTS);
+	glEnableClientState(GL_VERTEX_ARRAY);
 
 	//draw all the points in the global points vector onto the screen
-	for (const point& p : global.points)
-		glVertex2i(p.x, p.y);
+	glVertexPointer(2, GL_INT, sizeof(point), bind_buffer(GL_ARRAY_BUFFER, BUFFER_POINTS, global.points.data()));
+	glDrawArrays(GL_POINTS, 0, b.pointCount);
 
-	//stop drawing points
-	glEnd();
+	//draw all the triangles in the global mesh onto the screen, as lines between the mesh vertices
+	glVertexPointer(2, GL_INT, sizeof(point), bind_buffer(GL_ARRAY_BUFFER, BUFFER_VERTICES, global.mesh.points.data()));
+	glDrawElements(GL_LINES, b.edgeCount, GL_UNSIGNED_INT, bind_buffer(GL_ELEMENT_ARRAY_BUFFER, BUFFER_EDGES, b.edges.data()));
 
-	//draw all the triangles in the global tris vector onto the screen
-	for (const tri& t : global.tris)
+	//stop drawing from the buffers and flush to screen
+	if (b.bindBuffer != NULL)
 	{
-		glBegin(GL_LINE_STRIP);
-		glVertex2i(t.p1.x, t.p1.y);
-		glVertex2i(t.p2.x, t.p2.y);
-		glVertex2i(t.p3.x, t.p3.y);
-		glEnd();
+		b.bindBuffer(GL_ARRAY_BUFFER, 0);
+		b.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 	}
-
-	//flush the buffer to screen
+	glDisableClientState(GL_VERTEX_ARRAY);
 	glFlush();
 }
 
 //this method increments the global n value by 100
 //this is used to add 100 more points to the global points vector for generating random points
-//it ensures that the number of points will not exceed the size of the coords vector of all possible points
+//the new points carry on from the current sample, so they never repeat a point already drawn
+//it ensures that the number of points will not exceed the number of possible points
 void increment_n()
 {
-	//if the global n is already at the size of the coordinate vector, inform the user and don't increment
-	if (global.n == global.coords.size())
+	if (job_busy() || mesh_constrained())
+		return;
+
+	//if the sampler has already drawn every possible point, inform the user and don't increment
+	if (sampler_remaining(global.sample) == 0)
 	{
-		cout << "No more than " << global.n << " points allowed at current screen size!" << endl;
+		cout << "No more than " << global.sample.size << " points allowed at current screen size!" << endl;
 		return;
 	}
 
-	//check if the program has already shuffled the coords vector, if not, shuffle it
-	if (!global.shuffled)
+	//check if the program has already drawn from the sampler, if not, start with the first n points
+	int count = 10;
+	if (!global.sampled)
 	{
-		random_shuffle(global.coords.begin(), global.coords.end()); //shuffle the coordinate vector
-		global.shuffled = true;
-		global.n -= 10;
+		global.sampled = true;
+		count = global.n;
+		global.n = 0;
 	}
 
-	//add 10 points to the global points vector
-	global.n += 10;
-	for (int i = global.points.size(); i < global.n; i++)
-		global.points.push_back(point{ global.coords[i].x, global.coords[i].y }); //add the new point to the point vector
+	//if the points have been triangulated, insert the new points into the triangulation instead of starting over
+	if (he_face_count(global.mesh) > 0)
+	{
+		vector<point> newPoints;
+		global.n += sampler_take(global.sample, count, newPoints);
+		insert_points(newPoints);
+		glutPostRedisplay(); //redisplay the window
+		return;
+	}
+
+	//add up to 10 points to the global points vector, fewer if the sampler runs out
+	global.n += sampler_take(global.sample, count, global.points);
 
-	vector<edge>().swap(global.edges); //clear the edges vector, getting rid of its contents and freeing some memory
-	vector<tri>().swap(global.tris); //clear the tris vector, getting rid of its contents and freeing some memory
+	he_reset(global.mesh); //empty the mesh, keeping its memory for the next one
 
 	glutPostRedisplay(); //redisplay the window
 }
 
-//this method sets the global mouse draw bool to its opposite, and clears the global points vector is mouseDraw was set to true
+//this method sets the global mouse draw bool to its opposite, and clears the global points vector and mesh if mouseDraw was set to true
+//the mesh is cleared so the points drawn start a new set, rather than being inserted into the last triangulation
 void set_mouse_draw()
 {
+	if (job_busy())
+		return;
+
 	global.mouseDraw = !global.mouseDraw;
 	if (global.mouseDraw)
+	{
 		vector<point>().swap(global.points);
+		keys_clear(global.keys);
+		he_clear(global.mesh);
+	}
 }
 
 /*glut keyboard function*/
 void keyboard(unsigned char key, int x, int y)
 {
+	global.buffers.stale = true; //any action can change the points or mesh, so upload them again on the next draw
+
 	switch (key)
 	{
 	case 0x1B:
 	case'q':
 	case 'Q':
-		exit(0);
+		quit();
+		break;
+	case 'x':
+	case 'X':
+		cancel_job();
 		break;
 	case 'r':
 	case 'R':
@@ -714,18 +577,31 @@ void keyboard(unsigned char key, int x, int y)
 		break;
 	case 'c':
 	case 'C':
-		tri_cleanup();
+		cleanup();
+		break;
+	case 'f':
+	case 'F':
+		switch_cleanup_method();
+		break;
+	case 'k':
+	case 'K':
+		switch_constraints();
+		break;
 	}
 }//keyboard
 
 //Glut menu callback function
 void menuFunc(int value)
 {
+	global.buffers.stale = true; //any action can change the points or mesh, so upload them again on the next draw
+
 	switch (value)
 	{
 	case MENU_QUIT:
-		exit(0);
+		quit();
 		break;
+	case MENU_CANCEL:
+		cancel_job();
 		break;
 	case MENU_RANDOM:
 		random();
@@ -742,6 +618,15 @@ void menuFunc(int value)
 	case MENU_MOUSE:
 		set_mouse_draw();
 		break;
+	case MENU_CLEANUP:
+		cleanup();
+		break;
+	case MENU_CLEANUP_METHOD:
+		switch_cleanup_method();
+		break;
+	case MENU_CONSTRAIN:
+		switch_constraints();
+		break;
 	}
 
 	glutPostRedisplay();
@@ -750,7 +635,7 @@ void menuFunc(int value)
 //show the keys for actions in the terminal
 void show_keys()
 {
-	printf("Q:quit\nR:random\nM:mouse selection\nA:Add 100 points\nL:lattice\nT:triangulation\n");
+	printf("Q:quit\nR:random\nM:mouse selection\nA:Add 100 points\nL:lattice\nT:triangulation\nC:cleanup\nF:switch cleanup method\nK:switch constraints\nX:cancel job\n");
 }
 
 //Glut menu set up
@@ -763,34 +648,36 @@ void init_menu()
 	glutAddMenuEntry("Mouse Points", MENU_MOUSE);
 	glutAddMenuEntry("Lattice Points", MENU_LATTICE);
 	glutAddMenuEntry("Triangulation", MENU_TRIANGULATION);
+	glutAddMenuEntry("Cleanup", MENU_CLEANUP);
+	glutAddMenuEntry("Switch Cleanup Method", MENU_CLEANUP_METHOD);
+	glutAddMenuEntry("Switch Constraints", MENU_CONSTRAIN);
+	glutAddMenuEntry("Cancel Job", MENU_CANCEL);
 	glutAddMenuEntry("Quit", MENU_QUIT);
 	glutAttachMenu(GLUT_RIGHT_BUTTON);
 }
 
-//initialize the vector for coordinates
-void initializeVector()
-{
-	//initialize coordinate vector, going through all possible combinations of x and y (making sure points are only drawn within the visual bounds of the screen!)
-	for (int x = 1; x < global.w - 9; x++)
-		for (int y = 1; y < global.h - 9; y++)
-			global.coords.push_back(point{ x, y }); //add the point to the global vector of points
-}
-
 //what runs the whole show
 int main(int argc, char** argv)
 {
-	srand(static_cast <unsigned> (time(0))); //set a new random seed
-
 	global.w = 1000; //width and height set to 1000 x 800
 	global.h = 800;
 	global.n = 10; //set default number of points to 100 (maximum based on window size - 774,200)
-	initializeVector(); //initialize the coordinate vectors
+	global.cleanupMethod = CLEANUP_DELAUNAY; //use the circle test for cleanup by default
+	global.constrainMode = CONSTRAIN_NONE; //triangulate without constraints by default
 
 	glutInit(&argc, argv);
+
+	//seed the random number generator from the command line if a seed was given, so a run can be repeated, otherwise from the time
+	global.seed = argc > 1 ? strtoull(argv[1], NULL, 10) : static_cast <unsigned long long> (time(0));
+	rng_seed(global.generator, global.seed);
+	cout << "Seed: " << global.seed << endl;
+	initializeSampler(); //initialize the coordinate sampler
+
 	glutInitDisplayMode(GLUT_RGB | GLUT_SINGLE);
 
 	glutInitWindowSize(global.w, global.h);
-	glutCreateWindow("2D Triangulation");
+	glutCreateWindow(WINDOW_TITLE);
+	init_buffers(); //look up the buffer object functions, now that there is an opengl context
 	glShadeModel(GL_SMOOTH);
 	glutKeyboardFunc(keyboard);
 	glMatrixMode(GL_PROJECTION);
@@ -0,0 +1,573 @@
+/* This is a batch tool for the hull and triangulation algorithms, for running them on servers with no window or OpenGL context.
+* It reads one or more point files, runs the chosen operation on each one, and writes the results and timings to the console or a file.
+* Usage: Batch <operation> [options] <point files...>
+* The operations are hull, peel, cluster (cluster peel), triangulate (delaunay triangulation), cleanup (triangulation then cleanup),
+* locate (triangulation, then finding the triangle holding each query point, read from the file given with -q),
+* constrain (a constrained delaunay triangulation keeping the hull layers of the points as constraint edges, with the duplicates removed first),
+* and convert (writing the points to a binary geometry file, see geofile.h).
+* -o <file> writes to a file instead of the console, -m quick|monotone sets the hull method, -t <threads> sets the hull threads,
+* -k <clusters> sets the number of clusters, -c delaunay|shorter sets the cleanup criterion, and -s only writes the summary lines.
+* -l keep|drop prepares the points for the hull first (see prep.h), removing the duplicates and flagging the colinear runs,
+* then keeps the colinear points along the hull edges as vertices or drops them, and adds the duplicates and runs found to the summary line.
+* -x drops the holes of a constrained triangulation, keeping the triangles between the first and second layers, the third and fourth and so on.
+* -w <file> also writes the results of a single point file to a binary geometry file: the points for convert, the hull layers
+* (as indices into the points) for hull, peel and cluster, and the triangle mesh for the rest.
+* -b <points> streams the hull instead, reading that many points at a time and keeping only the points that could still be on the hull,
+* for point files too large to fit in memory. The hull is the same as with the whole file in memory, and the time includes reading the file.
+* -j <file> writes the totals of the instrumentation counters and phases over the whole run to a JSON file, and -e <file> writes every timed span
+* and the counters to a Chrome trace, for chrome://tracing or Perfetto (see stats.h).
+* A point file is either a binary geometry file, which is memory mapped and used in place, or holds whitespace separated x y integer pairs.
+* A file named - is read from standard input as text.
+* The output for each file starts with a summary line: file <name> <operation> points <n> <counts...> ms <time>.
+* Then each hull layer is written as "layer <vertex count>" followed by one "x y" line for each vertex in clockwise order,
+* and each triangle is written as "tri x1 y1 x2 y2 x3 y3" in counter clockwise order.
+* For locate, each query is then written as "at x y <triangle>", where triangle counts the tri lines from 0, or is -1 outside the triangulation.
+*/
+
+#include <stdlib.h>
+#include <climits>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include "../Geometry/halfedge.h"
+#include "../Geometry/hull.h"
+#include "../Geometry/grid.h"
+#include "../Geometry/triangulation.h"
+#include "../Geometry/store.h"
+#include "../Geometry/geofile.h"
+#include "../Geometry/prep.h"
+#include "../Geometry/stats.h"
+using namespace std;
+
+//the options structure, filled in from the command line
+typedef struct
+{
+	string operation; //the operation to run on each file
+	vector<string> files; //the point files to read
+	string output; //the file to write to, empty for the console
+	int hullMethod; //the algorithm used for hulls, either HULL_QUICK or HULL_MONOTONE
+	int threads; //the number of threads used for single hulls, cluster peels and queries
+	int clusters; //the number of clusters to create for the cluster peel
+	int cleanupMethod; //the criterion used by the cleanup, either CLEANUP_DELAUNAY or CLEANUP_SHORTER
+	bool summary; //true when only the summary lines are written
+	string queries; //the file of query points for locate
+	string binary; //the binary geometry file to write the results to, empty for none
+	int chunk; //the number of points read at a time for a streaming hull, 0 to read the whole file
+	string statsFile; //the JSON file to write the stats of the run to, empty for none
+	string traceFile; //the Chrome trace file to write the spans of the run to, empty for none
+	bool holes; //true when the constrained triangulation drops the triangles in the holes between its layers
+	int colinear; //what the prepared hull does with the colinear points along its edges, COLINEAR_KEEP or COLINEAR_DROP, or -1 to hull the points as they are
+} options;
+
+//this method prints how to use the tool
+void usage()
+{
+	cerr << "Usage: Batch <hull|peel|cluster|triangulate|cleanup|locate|constrain|convert> [options] <point files...>" << endl;
+	cerr << "  -o <file>              write the results to a file instead of the console" << endl;
+	cerr << "  -m quick|monotone      hull method (default quick)" << endl;
+	cerr << "  -t <threads>           threads used for a single hull, the clusters of a cluster peel or a batch of queries (default 1)" << endl;
+	cerr << "  -k <clusters>          number of clusters for the cluster peel, at most one for each point (default 5)" << endl;
+	cerr << "  -c delaunay|shorter    cleanup criterion (default delaunay)" << endl;
+	cerr << "  -q <file>              query points for locate" << endl;
+	cerr << "  -x                     drop every other band between the layers as a hole (constrain only)" << endl;
+	cerr << "  -s                     only write the summary line for each file" << endl;
+	cerr << "  -w <file>              write the results of a single point file to a binary geometry file (needed for convert)" << endl;
+	cerr << "  -b <points>            stream the hull, reading this many points at a time (hull only)" << endl;
+	cerr << "  -l keep|drop           remove duplicates first, and keep or drop the colinear hull vertices (hull only)" << endl;
+	cerr << "  -j <file>              write the counters and phase times of the run to a JSON file" << endl;
+	cerr << "  -e <file>              write the timed spans of the run to a Chrome trace file" << endl;
+	cerr << "Point files are binary geometry files, or hold whitespace separated x y integer pairs, - reads from standard input." << endl;
+}
+
+//this method reads the options from the command line
+//returns false when the command line is not valid
+bool parse_options(int argc, char** argv, options& opt)
+{
+	opt.hullMethod = HULL_QUICK;
+	opt.threads = 1;
+	opt.clusters = 5;
+	opt.cleanupMethod = CLEANUP_DELAUNAY;
+	opt.summary = false;
+	opt.chunk = 0;
+	opt.colinear = -1;
+	opt.holes = false;
+
+	if (argc < 2)
+		return false;
+
+	opt.operation = argv[1];
+	if (opt.operation != "hull" && opt.operation != "peel" && opt.operation != "cluster" && opt.operation != "triangulate" && opt.operation != "cleanup"
+		&& opt.operation != "locate" && opt.operation != "constrain" && opt.operation != "convert")
+		return false;
+
+	for (int i = 2; i < argc; i++)
+	{
+		string arg = argv[i];
+		bool hasValue = i + 1 < argc;
+
+		if (arg == "-s")
+			opt.summary = true;
+		else if (arg == "-x")
+			opt.holes = true;
+		else if (arg == "-o" && hasValue)
+			opt.output = argv[++i];
+		else if (arg == "-q" && hasValue)
+			opt.queries = argv[++i];
+		else if (arg == "-w" && hasValue)
+			opt.binary = argv[++i];
+		else if (arg == "-j" && hasValue)
+			opt.statsFile = argv[++i];
+		else if (arg == "-e" && hasValue)
+			opt.traceFile = argv[++i];
+		else if (arg == "-t" && hasValue)
+			opt.threads = max(1, atoi(argv[++i]));
+		else if (arg == "-b" && hasValue)
+			opt.chunk = max(1, atoi(argv[++i]));
+		else if (arg == "-k" && hasValue)
+			opt.clusters = max(1, atoi(argv[++i]));
+		else if (arg == "-m" && hasValue)
+		{
+			string value = argv[++i];
+			if (value == "quick")
+				opt.hullMethod = HULL_QUICK;
+			else if (value == "monotone")
+				opt.hullMethod = HULL_MONOTONE;
+			else
+				return false;
+		}
+		else if (arg == "-l" && hasValue)
+		{
+			string value = argv[++i];
+			if (value == "keep")
+				opt.colinear = COLINEAR_KEEP;
+			else if (value == "drop")
+				opt.colinear = COLINEAR_DROP;
+			else
+				return false;
+		}
+		else if (arg == "-c" && hasValue)
+		{
+			string value = argv[++i];
+			if (value == "delaunay")
+				opt.cleanupMethod = CLEANUP_DELAUNAY;
+			else if (value == "shorter")
+				opt.cleanupMethod = CLEANUP_SHORTER;
+			else
+				return false;
+		}
+		else if (arg.size() > 1 && arg[0] == '-')
+			return false;
+		else
+			opt.files.push_back(arg);
+	}
+
+	//locate needs a file of query points, and convert needs a binary file to write to
+	if ((opt.operation == "locate" && opt.queries.empty()) || (opt.operation == "convert" && opt.binary.empty()))
+		return false;
+
+	//a binary file only holds the results of one point file, only the hull can be streamed or prepared, and not both at once
+	if ((!opt.binary.empty() && opt.files.size() != 1) || (opt.chunk > 0 && opt.operation != "hull"))
+		return false;
+	if (opt.colinear != -1 && (opt.operation != "hull" || opt.chunk > 0))
+		return false;
+	if (opt.holes && opt.operation != "constrain")
+		return false;
+
+	return !opt.files.empty();
+}
+
+//this method reads the x y pairs in the stream into the points vector
+//returns false if the stream holds anything other than whole pairs of integers
+bool read_points(istream& in, vector<point>& points)
+{
+	vector<point>().swap(points); //clear the points vector
+
+	//stop at the end of the stream, but fail on a number without a pair or anything that isn't a number
+	int x, y;
+	while (in >> x)
+	{
+		if (!(in >> y))
+			return false;
+
+		points.push_back(point{ x, y });
+	}
+
+	return in.eof();
+}
+
+//this method reads up to n more x y pairs from the stream into the points vector, replacing what was in it
+//returns false if the stream holds anything other than whole pairs of integers
+bool read_chunk(istream& in, int n, vector<point>& points)
+{
+	vector<point>().swap(points); //clear the points vector
+
+	int x, y;
+	while (points.size() < n && in >> x)
+	{
+		if (!(in >> y))
+			return false;
+
+		points.push_back(point{ x, y });
+	}
+
+	return points.size() == n || in.eof();
+}
+
+//this method writes a hull layer, given as indices into the points, to the output
+void write_layer(ostream& out, const point_view& points, const vector<int>& layer)
+{
+	out << "layer " << layer.size() << "\n";
+	for (int i : layer)
+	{
+		point p = view_get(points, i);
+		out << p.x << " " << p.y << "\n";
+	}
+}
+
+//this method writes the results to the binary geometry file given with -w: the points for convert, the hull layers or the triangle mesh
+//returns false if the file cannot be written
+bool write_binary(const options& opt, const point_view& points, const vector<vector<vector<int>>>& layerIdx, const halfedge_mesh& mesh)
+{
+	if (opt.operation == "convert")
+		return geofile_write_points(opt.binary, points);
+
+	if (opt.operation == "hull" || opt.operation == "peel" || opt.operation == "cluster")
+	{
+		vector<vector<int>> layers;
+		for (const vector<vector<int>>& set : layerIdx)
+			layers.insert(layers.end(), set.begin(), set.end());
+
+		return geofile_write_layers(opt.binary, points.count, layers);
+	}
+
+	return geofile_write_mesh(opt.binary, mesh);
+}
+
+//this method runs the operation on one set of points, writing the summary line and the results to the output
+//the points are read in place through the view, so a memory mapped file is never copied (except by the cluster peel, which needs its own copy)
+//returns false if the binary results could not be written
+bool run(ostream& out, const options& opt, const string& name, const point_view& points, const vector<point>& queries)
+{
+	vector<vector<vector<int>>> layerIdx; //the hull layers of each cluster (or of all the points), as indices into the points
+	halfedge_mesh mesh;
+	int flips = 0;
+	vector<int> found; //the triangle holding each query point, for locate
+	vector<point> copy; //a copy of the points, for the cluster peel, the prepared hull and the constrained triangulation
+	prepared_points prep; //the prepared points, for the prepared hull and the constrained triangulation
+	tri_constraints constraints; //the constraint edges of the constrained triangulation
+	vector<vector<int>> rings; //the hull layers the constrained triangulation keeps, as indices into the prepared points
+	bool prepared = opt.operation == "hull" && opt.colinear != -1;
+	if (opt.operation == "cluster" || opt.operation == "constrain" || prepared)
+		view_points(points, copy);
+
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+	if (opt.operation == "convert")
+	{
+		//the points are written below, which is all convert does
+	}
+	else if (opt.operation == "hull")
+	{
+		vector<int> ring;
+		if (prepared)
+		{
+			prep_points(copy, prep);
+			prep_hull(prep, opt.colinear, ring);
+		}
+		else
+			compute_hull(points, opt.hullMethod, opt.threads, ring);
+		layerIdx.push_back(vector<vector<int>>());
+		if (!ring.empty())
+			layerIdx.back().push_back(ring);
+	}
+	else if (opt.operation == "peel")
+	{
+		layerIdx.push_back(vector<vector<int>>());
+		peel_layers(points, layerIdx.back());
+	}
+	else if (opt.operation == "cluster")
+	{
+		//split the points into clusters the same way the hull peeler does, then peel the clusters on the threads
+		vector<vector<int>> groups;
+		vector<int> leftover;
+
+		//there can't be more clusters than points, as the clusters would have no points in them
+		int clusters = max(1, min(opt.clusters, (int)copy.size()));
+		make_clusters(copy, clusters, copy.size() / clusters, groups, leftover);
+		peel_clusters(copy, groups, opt.threads, layerIdx);
+	}
+	else if (opt.operation == "constrain")
+	{
+		//the peel needs points without duplicates, so the layers and the triangulation are made from the prepared points
+		prep_points(copy, prep);
+		peel_layers(prep.points, rings);
+		if (!constrained_delaunay(prep.points, rings, opt.holes, mesh, constraints))
+			cerr << "Some layer edges of " << name << " cross other layers and were left out." << endl;
+	}
+	else
+	{
+		delaunay(points, mesh);
+		if (opt.operation == "cleanup")
+			flips = tri_cleanup(mesh, opt.cleanupMethod);
+		else if (opt.operation == "locate")
+		{
+			tri_locator locator;
+			locator_build(locator, mesh);
+			locator_find_all(locator, mesh, queries, opt.threads, found);
+		}
+	}
+
+	//write the binary results, which is timed for convert, as that is all it does
+	bool written = opt.binary.empty() || opt.operation != "convert" || write_binary(opt, points, layerIdx, mesh);
+
+	chrono::duration<double, milli> elapsed = chrono::steady_clock::now() - start;
+
+	if (!opt.binary.empty() && opt.operation != "convert")
+		written = write_binary(opt, points, layerIdx, mesh);
+	if (!written)
+		cerr << "Could not write " << opt.binary << "." << endl;
+
+	//write the summary line
+	out << "file " << name << " " << opt.operation << " points " << points.count;
+	if (opt.operation == "triangulate" || opt.operation == "cleanup" || opt.operation == "locate" || opt.operation == "constrain")
+	{
+		out << " triangles " << he_face_count(mesh);
+		if (opt.operation == "cleanup")
+			out << " flips " << flips;
+		else if (opt.operation == "constrain")
+		{
+			int edges = 0;
+			for (int h = 0; h < constraints.fixed.size(); h++)
+				if (constraints.fixed[h] > 0 && (mesh.twin[h] == -1 || mesh.twin[h] > h))
+					edges++;
+			out << " layers " << rings.size() << " constraints " << edges;
+		}
+		else if (opt.operation == "locate")
+			out << " queries " << queries.size() << " found " << count_if(found.begin(), found.end(), [](int f) { return f != -1; });
+	}
+	else if (opt.operation != "convert")
+	{
+		int layers = 0, edges = 0;
+		for (const vector<vector<int>>& set : layerIdx)
+		{
+			layers += set.size();
+			for (const vector<int>& layer : set)
+				edges += layer.size();
+		}
+
+		if (opt.operation == "cluster")
+			out << " clusters " << layerIdx.size();
+		out << " layers " << layers << " edges " << edges;
+		if (prepared)
+			out << " duplicates " << prep.duplicates << " runs " << prep.runs;
+	}
+	out << " ms " << elapsed.count() << "\n";
+
+	if (opt.summary)
+		return written;
+
+	//write the results
+	for (const vector<vector<int>>& set : layerIdx)
+		for (const vector<int>& layer : set)
+			write_layer(out, points, layer);
+
+	for (int f = 0; f < he_face_count(mesh); f++)
+	{
+		out << "tri";
+		for (int i = 0; i < 3; i++)
+			out << " " << mesh.points[mesh.origin[3 * f + i]].x << " " << mesh.points[mesh.origin[3 * f + i]].y;
+		out << "\n";
+	}
+
+	for (int i = 0; i < found.size(); i++)
+		out << "at " << queries[i].x << " " << queries[i].y << " " << found[i] << "\n";
+
+	return written;
+}
+
+//this method streams the hull of one point file, writing the summary line and the hull to the output
+//the file is read opt.chunk points at a time, so only one chunk and the points that could still be on the hull are ever in memory
+//returns false if the file could not be read or the binary results could not be written
+bool run_stream(ostream& out, const options& opt, const string& name)
+{
+	stream_hull h;
+	stream_hull_clear(h);
+	vector<point> chunk;
+	bool ok = true;
+
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+	if (name != "-" && geofile_check(name))
+	{
+		geofile_reader r;
+		ok = geofile_reader_open(r, name);
+
+		int n;
+		while (ok && (n = geofile_read(r, opt.chunk, chunk)) != 0)
+		{
+			ok = n > 0;
+			stream_hull_add(h, chunk.data(), chunk.size());
+		}
+	}
+	else
+	{
+		ifstream file;
+		if (name != "-")
+			file.open(name);
+		istream& in = name == "-" ? cin : file;
+
+		ok = (bool)in;
+		while (ok && !in.eof())
+		{
+			ok = read_chunk(in, opt.chunk, chunk);
+			stream_hull_add(h, chunk.data(), chunk.size());
+		}
+	}
+
+	if (!ok)
+	{
+		cerr << "Could not read points from " << name << ", skipping it." << endl;
+		return false;
+	}
+
+	vector<int> ring;
+	stream_hull_ring(h, opt.hullMethod, ring);
+
+	chrono::duration<double, milli> elapsed = chrono::steady_clock::now() - start;
+
+	//write the binary results, as indices into the whole file, which only fit when it has no more points than an int can index
+	bool written = true;
+	if (!opt.binary.empty())
+	{
+		vector<vector<int>> layers;
+		if (!ring.empty())
+		{
+			layers.push_back(vector<int>());
+			for (int i : ring)
+				layers.back().push_back((int)h.index[i]);
+		}
+
+		written = h.count <= INT_MAX && geofile_write_layers(opt.binary, (int)h.count, layers);
+		if (!written)
+			cerr << "Could not write " << opt.binary << "." << endl;
+	}
+
+	//write the summary line, then the hull
+	out << "file " << name << " hull points " << h.count << " layers " << (ring.empty() ? 0 : 1) << " edges " << ring.size() << " ms " << elapsed.count() << "\n";
+
+	if (!opt.summary && !ring.empty())
+	{
+		out << "layer " << ring.size() << "\n";
+		for (int i : ring)
+			out << h.points[i].x << " " << h.points[i].y << "\n";
+	}
+
+	return written;
+}
+
+//what runs the whole show
+int main(int argc, char** argv)
+{
+	options opt;
+	if (!parse_options(argc, argv, opt))
+	{
+		usage();
+		return 1;
+	}
+
+	//write to the output file if one was given, otherwise to the console
+	ofstream file;
+	if (!opt.output.empty())
+	{
+		file.open(opt.output);
+		if (!file)
+		{
+			cerr << "Could not open " << opt.output << " for writing." << endl;
+			return 1;
+		}
+	}
+	ostream& out = opt.output.empty() ? cout : file;
+
+	//read the query points for locate
+	vector<point> queries;
+	if (!opt.queries.empty())
+	{
+		ifstream in(opt.queries);
+		if (!in || !read_points(in, queries))
+		{
+			cerr << "Could not read query points from " << opt.queries << "." << endl;
+			return 1;
+		}
+	}
+
+	//run the operation on each file, carrying on past any that can't be read
+	//a binary file is mapped and its points used in place, while a text file is read into a store, which is compact when the points fit
+	int result = 0;
+	vector<point> points;
+	point_store store;
+	for (const string& name : opt.files)
+	{
+		if (opt.chunk > 0)
+		{
+			if (!run_stream(out, opt, name))
+				result = 1;
+			continue;
+		}
+
+		bool ok;
+		geofile f;
+		bool binary = name != "-" && geofile_check(name);
+		if (binary)
+			ok = geofile_open(f, name) && (f.points.xs != NULL || f.points.cx != NULL);
+		else if (name == "-")
+			ok = read_points(cin, points);
+		else
+		{
+			ifstream in(name);
+			ok = in && read_points(in, points);
+		}
+
+		if (!ok)
+		{
+			cerr << "Could not read points from " << name << ", skipping it." << endl;
+			if (binary)
+				geofile_close(f);
+			result = 1;
+			continue;
+		}
+
+		point_view view;
+		if (binary)
+			view = f.points;
+		else
+		{
+			store_build(store, points, true);
+			vector<point>().swap(points); //the store holds the points now
+			view = store_view(store);
+		}
+
+		if (!run(out, opt, name, view, queries))
+			result = 1;
+
+		if (binary)
+			geofile_close(f);
+	}
+
+	//write the stats of the whole run
+	if (!opt.statsFile.empty() && !stats_write_json(opt.statsFile))
+	{
+		cerr << "Could not write " << opt.statsFile << "." << endl;
+		result = 1;
+	}
+	if (!opt.traceFile.empty() && !stats_write_trace(opt.traceFile))
+	{
+		cerr << "Could not write " << opt.traceFile << "." << endl;
+		result = 1;
+	}
+
+	out.flush();
+	return result;
+}
@@ -0,0 +1,413 @@
+/* This is a benchmark for the hull and triangulation algorithms, for catching speed regressions between builds.
+* It times each algorithm over fixed seed point distributions at sizes from 100 points up, repeating each run to get stable numbers.
+* Usage: Bench [options]
+* The benchmarks are hull (quick hull), monotone (monotone chain hull), peel, cluster (cluster peel), triangulate (delaunay triangulation) and cleanup.
+* The distributions are uniform (distinct points in a window like random()), lattice (like lattice()), circle (points on a circle),
+* gaussian (points in gaussian clusters) and colinear (most points on a few lines, the rest uniform).
+* -o <file> writes to a file instead of the console, -r <reps> sets the number of runs of each benchmark, -n <size> sets the largest size,
+* -b and -d pick the benchmarks and distributions (comma separated), -s <seed> sets the seed, -t <threads> sets the hull threads,
+* -c delaunay|shorter sets the cleanup criterion, -p array|store|compact sets how the points are laid out,
+* and -f none|quad|octagon sets the interior point filter the hull and monotone benchmarks run first (which is timed along with the hull).
+* The output is comma separated, with a header line, then one line for each benchmark, distribution and size:
+* benchmark,distribution,size,reps,median_ms,p10_ms,p90_ms,min_ms,max_ms,result
+* where result is the number of hull edges, layer edges, triangles or flips, so a change in the output is caught along with a change in speed.
+* The same seed always gives the same points, so two builds can be compared line by line, and every layout gives the same results.
+*/
+
+#include <stdlib.h>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include "../Geometry/halfedge.h"
+#include "../Geometry/hull.h"
+#include "../Geometry/grid.h"
+#include "../Geometry/triangulation.h"
+#include "../Geometry/sample.h"
+#include "../Geometry/store.h"
+using namespace std;
+
+//enums for the benchmarks and distributions, in the same order as their names
+enum {
+	BENCH_HULL, BENCH_MONOTONE, BENCH_PEEL, BENCH_CLUSTER, BENCH_TRIANGULATE, BENCH_CLEANUP, BENCH_COUNT
+};
+enum {
+	DIST_UNIFORM, DIST_LATTICE, DIST_CIRCLE, DIST_GAUSSIAN, DIST_COLINEAR, DIST_COUNT
+};
+const char* benchNames[BENCH_COUNT] = { "hull", "monotone", "peel", "cluster", "triangulate", "cleanup" };
+const char* distNames[DIST_COUNT] = { "uniform", "lattice", "circle", "gaussian", "colinear" };
+
+//enums for the point layouts: a vector of points, a wide point store, or a compact point store (wide when the points don't fit)
+enum {
+	LAYOUT_ARRAY, LAYOUT_STORE, LAYOUT_COMPACT
+};
+
+//the window size used by random(), which the uniform, circle and colinear points are scaled from
+const int WINDOW_W = 990, WINDOW_H = 790;
+
+//the options structure, filled in from the command line
+typedef struct
+{
+	string output; //the file to write to, empty for the console
+	int reps; //the number of times each benchmark is run
+	int maxSize; //the largest number of points to run at
+	vector<bool> benches; //true for each benchmark to run
+	vector<bool> dists; //true for each distribution to run
+	unsigned long long seed; //the seed all the point sets are made from
+	int threads; //the number of threads used for the hulls
+	int cleanupMethod; //the criterion used by the cleanup, either CLEANUP_DELAUNAY or CLEANUP_SHORTER
+	int layout; //how the points are given to the hull, peel and triangulation, one of the LAYOUT enums
+	int filter; //the interior point filter run ahead of the hulls, one of the HULL_FILTER enums
+} options;
+
+//this method prints how to use the tool
+void usage()
+{
+	cerr << "Usage: Bench [options]" << endl;
+	cerr << "  -o <file>              write the results to a file instead of the console" << endl;
+	cerr << "  -r <reps>              runs of each benchmark (default 5)" << endl;
+	cerr << "  -n <size>              largest number of points, from 100 up in powers of 10 (default 1000000, up to 10000000)" << endl;
+	cerr << "  -b <benchmarks>        comma separated, from hull,monotone,peel,cluster,triangulate,cleanup (default all)" << endl;
+	cerr << "  -d <distributions>     comma separated, from uniform,lattice,circle,gaussian,colinear (default all)" << endl;
+	cerr << "  -s <seed>              seed for the point sets (default 1)" << endl;
+	cerr << "  -t <threads>           threads used for the hulls (default 1)" << endl;
+	cerr << "  -c delaunay|shorter    cleanup criterion (default delaunay)" << endl;
+	cerr << "  -p array|store|compact point layout for hull, monotone, peel and triangulate (default array)" << endl;
+	cerr << "  -f none|quad|octagon   interior point filter ahead of hull and monotone (default none)" << endl;
+}
+
+//this method sets selected to true for each name in the comma separated list, which are looked up in names
+//returns false if a name in the list is not one of the names
+bool parse_list(const string& list, const char* const* names, int count, vector<bool>& selected)
+{
+	selected.assign(count, false);
+
+	stringstream in(list);
+	string name;
+	while (getline(in, name, ','))
+	{
+		int i = 0;
+		while (i < count && name != names[i])
+			i++;
+		if (i == count)
+			return false;
+
+		selected[i] = true;
+	}
+
+	return true;
+}
+
+//this method reads the options from the command line
+//returns false when the command line is not valid
+bool parse_options(int argc, char** argv, options& opt)
+{
+	opt.reps = 5;
+	opt.maxSize = 1000000;
+	opt.benches.assign(BENCH_COUNT, true);
+	opt.dists.assign(DIST_COUNT, true);
+	opt.seed = 1;
+	opt.threads = 1;
+	opt.cleanupMethod = CLEANUP_DELAUNAY;
+	opt.layout = LAYOUT_ARRAY;
+	opt.filter = HULL_FILTER_NONE;
+
+	for (int i = 1; i < argc; i++)
+	{
+		string arg = argv[i];
+		if (i + 1 >= argc)
+			return false;
+
+		string value = argv[++i];
+		if (arg == "-o")
+			opt.output = value;
+		else if (arg == "-r")
+			opt.reps = max(1, atoi(value.c_str()));
+		else if (arg == "-n")
+			opt.maxSize = max(100, atoi(value.c_str()));
+		else if (arg == "-s")
+			opt.seed = strtoull(value.c_str(), NULL, 10);
+		else if (arg == "-t")
+			opt.threads = max(1, atoi(value.c_str()));
+		else if (arg == "-b")
+		{
+			if (!parse_list(value, benchNames, BENCH_COUNT, opt.benches))
+				return false;
+		}
+		else if (arg == "-d")
+		{
+			if (!parse_list(value, distNames, DIST_COUNT, opt.dists))
+				return false;
+		}
+		else if (arg == "-c")
+		{
+			if (value == "delaunay")
+				opt.cleanupMethod = CLEANUP_DELAUNAY;
+			else if (value == "shorter")
+				opt.cleanupMethod = CLEANUP_SHORTER;
+			else
+				return false;
+		}
+		else if (arg == "-p")
+		{
+			if (value == "array")
+				opt.layout = LAYOUT_ARRAY;
+			else if (value == "store")
+				opt.layout = LAYOUT_STORE;
+			else if (value == "compact")
+				opt.layout = LAYOUT_COMPACT;
+			else
+				return false;
+		}
+		else if (arg == "-f")
+		{
+			if (value == "none")
+				opt.filter = HULL_FILTER_NONE;
+			else if (value == "quad")
+				opt.filter = HULL_FILTER_QUAD;
+			else if (value == "octagon")
+				opt.filter = HULL_FILTER_OCTAGON;
+			else
+				return false;
+		}
+		else
+			return false;
+	}
+
+	return true;
+}
+
+//this method returns a random number in [0, 1)
+double rng_unit(rng& r)
+{
+	return (rng_next(r) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+//this method returns a random int in [lo, hi]
+int rng_int(rng& r, int lo, int hi)
+{
+	return lo + (int)(rng_unit(r) * ((long long)hi - lo + 1));
+}
+
+//this method fills points with n points from the given distribution, always the same points for the same seed
+//the window is grown for large sizes, so there is always room for n distinct uniform points and the circle doesn't fold onto itself
+void make_points(int dist, int n, unsigned long long seed, vector<point>& points)
+{
+	vector<point>().swap(points); //clear the points vector
+	points.reserve(n);
+
+	//each distribution and size gets its own stream of numbers from the seed
+	rng r;
+	rng_seed(r, seed ^ ((unsigned long long)dist << 40) ^ (unsigned long long)n);
+
+	int scale = max(1, (int)ceil(sqrt(2.0 * n / ((double)WINDOW_W * WINDOW_H))));
+	int w = WINDOW_W * scale, h = WINDOW_H * scale;
+
+	if (dist == DIST_UNIFORM)
+	{
+		//distinct points in the window, drawn the same way random() draws them
+		sampler s;
+		sampler_init(s, 1, 1, w, h, rng_next(r));
+		sampler_take(s, n, points);
+	}
+	else if (dist == DIST_LATTICE)
+	{
+		//the first n points of a square lattice with a spacing of 5, like lattice()
+		int side = (int)ceil(sqrt((double)n));
+		for (int i = 0; i < n; i++)
+			points.push_back(point{ i / side * 5, i % side * 5 });
+	}
+	else if (dist == DIST_CIRCLE)
+	{
+		//points at random angles on a circle filling the window, rounded to the nearest coordinate
+		double radius = max((double)h / 2, n / 6.0);
+		for (int i = 0; i < n; i++)
+		{
+			double angle = rng_unit(r) * 6.283185307179586;
+			points.push_back(point{ (int)lround(radius + radius * cos(angle)), (int)lround(radius + radius * sin(angle)) });
+		}
+	}
+	else if (dist == DIST_GAUSSIAN)
+	{
+		//points around 10 cluster centres, each with its own spread, using the box muller transform
+		const int clusters = 10;
+		double cx[clusters], cy[clusters], spread[clusters];
+		for (int c = 0; c < clusters; c++)
+		{
+			cx[c] = w * (0.1 + 0.8 * rng_unit(r));
+			cy[c] = h * (0.1 + 0.8 * rng_unit(r));
+			spread[c] = min(w, h) * (0.01 + 0.05 * rng_unit(r));
+		}
+
+		for (int i = 0; i < n; i++)
+		{
+			int c = i % clusters;
+			double len = sqrt(-2.0 * log(1.0 - rng_unit(r))), angle = rng_unit(r) * 6.283185307179586;
+			points.push_back(point{ (int)lround(cx[c] + spread[c] * len * cos(angle)), (int)lround(cy[c] + spread[c] * len * sin(angle)) });
+		}
+	}
+	else
+	{
+		//nine in ten points on a few horizontal, vertical and diagonal lines, with exact integer coordinates, the rest uniform
+		for (int i = 0; i < n; i++)
+		{
+			int x = rng_int(r, 1, w), y = rng_int(r, 1, h);
+			switch (i % 10)
+			{
+			case 0: y = h / 2; break;
+			case 1: y = h / 4; break;
+			case 2: x = w / 2; break;
+			case 3: x = w / 3; break;
+			case 4: y = min(h, x); break;
+			case 5: y = min(h, max(1, h - x)); break;
+			case 6: x = min(w, 2 * y); break;
+			case 7: y = h; break;
+			case 8: x = 1; break;
+			}
+			points.push_back(point{ x, y });
+		}
+	}
+}
+
+//this method runs the benchmark once on the points, returning the time it took in milliseconds
+//result is set to the size of the output (hull edges, layer edges, triangles or flips)
+//the hulls, peel and triangulation run on the view of the store instead of the points unless the layout is LAYOUT_ARRAY
+//for the cleanup, the triangulation is made first and only the cleanup is timed
+double run_bench(int bench, const options& opt, const vector<point>& points, const point_view& view, long long& result)
+{
+	vector<int> ring;
+	vector<vector<int>> layers;
+	halfedge_mesh mesh;
+	hull_scratch scratch;
+	result = 0;
+
+	if (bench == BENCH_CLEANUP)
+		delaunay(points, mesh);
+
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+	switch (bench)
+	{
+	case BENCH_HULL:
+	case BENCH_MONOTONE:
+		if (opt.layout == LAYOUT_ARRAY)
+			filtered_hull(points, bench == BENCH_HULL ? HULL_QUICK : HULL_MONOTONE, opt.threads, opt.filter, ring, scratch);
+		else
+			filtered_hull(view, bench == BENCH_HULL ? HULL_QUICK : HULL_MONOTONE, opt.threads, opt.filter, ring, scratch);
+		result = ring.size();
+		break;
+	case BENCH_PEEL:
+		if (opt.layout == LAYOUT_ARRAY)
+			peel_layers(points, layers);
+		else
+			peel_layers(view, layers);
+		for (const vector<int>& layer : layers)
+			result += layer.size();
+		break;
+	case BENCH_CLUSTER:
+	{
+		//split the points into clusters the same way the hull peeler does, then peel each one
+		vector<vector<int>> groups;
+		vector<int> leftover;
+		vector<point> clusterPoints;
+		make_clusters(points, 5, points.size() / 5, groups, leftover);
+
+		for (const vector<int>& group : groups)
+		{
+			vector<point>().swap(clusterPoints);
+			for (int j : group)
+				clusterPoints.push_back(points[j]);
+
+			peel_layers(clusterPoints, layers);
+			for (const vector<int>& layer : layers)
+				result += layer.size();
+		}
+		break;
+	}
+	case BENCH_TRIANGULATE:
+		if (opt.layout == LAYOUT_ARRAY)
+			delaunay(points, mesh);
+		else
+			delaunay(view, mesh);
+		result = he_face_count(mesh);
+		break;
+	case BENCH_CLEANUP:
+		result = tri_cleanup(mesh, opt.cleanupMethod);
+		break;
+	}
+
+	chrono::duration<double, milli> elapsed = chrono::steady_clock::now() - start;
+	return elapsed.count();
+}
+
+//this method returns the given percentile of the sorted times, using the nearest rank
+double percentile(const vector<double>& sorted, double p)
+{
+	int rank = (int)ceil(p / 100 * sorted.size());
+	return sorted[max(0, min((int)sorted.size() - 1, rank - 1))];
+}
+
+//what runs the whole show
+int main(int argc, char** argv)
+{
+	options opt;
+	if (!parse_options(argc, argv, opt))
+	{
+		usage();
+		return 1;
+	}
+
+	//write to the output file if one was given, otherwise to the console
+	ofstream file;
+	if (!opt.output.empty())
+	{
+		file.open(opt.output);
+		if (!file)
+		{
+			cerr << "Could not open " << opt.output << " for writing." << endl;
+			return 1;
+		}
+	}
+	ostream& out = opt.output.empty() ? cout : file;
+
+	out << "benchmark,distribution,size,reps,median_ms,p10_ms,p90_ms,min_ms,max_ms,result" << endl;
+
+	//make each point set (and its store) once, then run every benchmark on it
+	vector<point> points;
+	point_store store;
+	store_clear(store);
+	vector<double> times;
+	for (int d = 0; d < DIST_COUNT; d++)
+	{
+		if (!opt.dists[d])
+			continue;
+
+		for (long long n = 100; n <= opt.maxSize; n *= 10)
+		{
+			make_points(d, n, opt.seed, points);
+			if (opt.layout != LAYOUT_ARRAY)
+				store_build(store, points, opt.layout == LAYOUT_COMPACT);
+			point_view view = store_view(store);
+
+			for (int b = 0; b < BENCH_COUNT; b++)
+			{
+				if (!opt.benches[b])
+					continue;
+
+				long long result = 0;
+				vector<double>().swap(times);
+				for (int rep = 0; rep < opt.reps; rep++)
+					times.push_back(run_bench(b, opt, points, view, result));
+				sort(times.begin(), times.end());
+
+				out << benchNames[b] << "," << distNames[d] << "," << n << "," << opt.reps << "," << percentile(times, 50) << "," << percentile(times, 10) << "," << percentile(times, 90) << "," << times.front() << "," << times.back() << "," << result << endl;
+			}
+		}
+	}
+
+	return 0;
+}
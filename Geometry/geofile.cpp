@@ -0,0 +1,427 @@
+/* This is the implementation of the binary geometry file format, with the memory map for reading it on windows and on posix systems.
+* See geofile.h for how a file is laid out.
+*/
+
+#include <string.h>
+#include <climits>
+#include <fstream>
+#include <algorithm>
+#include "geofile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+using namespace std;
+
+//a section of a geometry file being written, the bytes of which are written as they are in memory
+typedef struct
+{
+	bool present; //true when the file has this section, even if it is empty
+	const void* data; //the contents of the section
+	long long bytes; //the size of the section in bytes
+} section;
+
+//this method checks if the machine stores numbers little endian, which the arrays of every geometry file are in
+//the sections are used in place, so a file can't be read or written on a big endian machine
+static bool little_endian()
+{
+	unsigned int one = 1;
+	return *(const unsigned char*)&one == 1;
+}
+
+//this method rounds the offset up to the next GEOFILE_ALIGN boundary
+static long long align_up(long long offset)
+{
+	return (offset + GEOFILE_ALIGN - 1) / GEOFILE_ALIGN * GEOFILE_ALIGN;
+}
+
+//this method fills in a header for a file of pointCount points with the given flags and origin, with no sections yet
+static void init_header(geofile_header& h, long long pointCount, unsigned int flags, point origin)
+{
+	memset(&h, 0, sizeof(h));
+	memcpy(h.magic, GEOFILE_MAGIC, sizeof(h.magic));
+	h.version = GEOFILE_VERSION;
+	h.flags = flags;
+	h.originX = origin.x;
+	h.originY = origin.y;
+	h.pointCount = pointCount;
+}
+
+//this method writes a geometry file with the header and the sections that are present, filling in the offset of each section in the header
+//the sections follow the header in order, each one padded with zeros to start on a GEOFILE_ALIGN boundary
+//returns false if the file cannot be written
+static bool write_file(const string& path, geofile_header& h, const section sections[GEO_SECTIONS])
+{
+	if (!little_endian())
+		return false;
+
+	//lay out the sections one after the other
+	long long at = align_up(sizeof(geofile_header));
+	for (int s = 0; s < GEO_SECTIONS; s++)
+	{
+		h.offset[s] = sections[s].present ? at : 0;
+		if (sections[s].present)
+			at = align_up(at + sections[s].bytes);
+	}
+
+	ofstream out(path, ios::binary);
+	if (!out)
+		return false;
+
+	out.write((const char*)&h, sizeof(h));
+
+	long long pos = sizeof(h);
+	const char zeros[GEOFILE_ALIGN] = {};
+	for (int s = 0; s < GEO_SECTIONS; s++)
+	{
+		if (!sections[s].present)
+			continue;
+
+		out.write(zeros, h.offset[s] - pos);
+		if (sections[s].bytes > 0)
+			out.write((const char*)sections[s].data, sections[s].bytes);
+		pos = h.offset[s] + sections[s].bytes;
+	}
+
+	return (bool)out;
+}
+
+//this method sets the x and y sections to the coordinate arrays of the view
+static void point_sections(const point_view& v, section sections[GEO_SECTIONS])
+{
+	long long bytes = (long long)v.count * (v.compact ? sizeof(unsigned short) : sizeof(int));
+	sections[GEO_X] = section{ true, v.compact ? (const void*)v.cx : (const void*)v.xs, bytes };
+	sections[GEO_Y] = section{ true, v.compact ? (const void*)v.cy : (const void*)v.ys, bytes };
+}
+
+//this method writes the points in the view to a geometry file at path, compact if the view is compact
+bool geofile_write_points(const string& path, const point_view& v)
+{
+	geofile_header h;
+	init_header(h, v.count, v.compact ? GEOFILE_COMPACT : 0, v.origin);
+
+	section sections[GEO_SECTIONS] = {};
+	point_sections(v, sections);
+
+	return write_file(path, h, sections);
+}
+
+//this method writes hull layers, given as indices into a set of pointCount points, to a geometry file at path with no coordinates
+//the layers are joined into one array of vertices, with the start of each layer in another
+bool geofile_write_layers(const string& path, int pointCount, const vector<vector<int>>& layers)
+{
+	vector<int> start(1, 0), index;
+	for (const vector<int>& layer : layers)
+	{
+		index.insert(index.end(), layer.begin(), layer.end());
+		start.push_back(index.size());
+	}
+
+	geofile_header h;
+	init_header(h, pointCount, 0, point{ 0, 0 });
+	h.layerCount = layers.size();
+	h.layerIndexCount = index.size();
+
+	section sections[GEO_SECTIONS] = {};
+	sections[GEO_LAYER_START] = section{ true, start.data(), (long long)start.size() * (long long)sizeof(int) };
+	sections[GEO_LAYER_INDEX] = section{ true, index.data(), (long long)index.size() * (long long)sizeof(int) };
+
+	return write_file(path, h, sections);
+}
+
+//this method writes the triangle mesh to a geometry file at path, with its points, which are compact if they fit in STORE_COMPACT_RANGE
+bool geofile_write_mesh(const string& path, const halfedge_mesh& m)
+{
+	if (!m.next.empty())
+		return false;
+
+	point_store s;
+	store_build(s, m.points, true);
+	point_view v = store_view(s);
+
+	geofile_header h;
+	init_header(h, v.count, v.compact ? GEOFILE_COMPACT : 0, v.origin);
+	h.halfedgeCount = m.origin.size();
+
+	section sections[GEO_SECTIONS] = {};
+	point_sections(v, sections);
+	sections[GEO_ORIGIN] = section{ true, m.origin.data(), (long long)m.origin.size() * (long long)sizeof(int) };
+	sections[GEO_TWIN] = section{ true, m.twin.data(), (long long)m.twin.size() * (long long)sizeof(int) };
+
+	return write_file(path, h, sections);
+}
+
+//this method checks if the file at path starts with GEOFILE_MAGIC, telling a geometry file apart from a text point file
+bool geofile_check(const string& path)
+{
+	ifstream in(path, ios::binary);
+	char magic[sizeof(GEOFILE_MAGIC)];
+
+	return in.read(magic, sizeof(magic)) && memcmp(magic, GEOFILE_MAGIC, sizeof(magic)) == 0;
+}
+
+//this method checks that section s of a file of the given size, which should be the given number of bytes, is aligned and fits in the file
+//a section the file doesn't have is always fine
+static bool section_fits(const geofile_header& h, long long size, int s, long long bytes)
+{
+	long long offset = h.offset[s];
+
+	return offset == 0 || (offset % GEOFILE_ALIGN == 0 && offset >= (long long)sizeof(geofile_header) && offset <= size && bytes <= size - offset);
+}
+
+//this method checks the header of a file of the given size, with at most maxPoints points
+//only the mapped files need every count to fit in the int indices the algorithms use, as a file read a chunk at a time can hold any number of points
+//returns false if the header is not valid, or any section does not fit in the file
+static bool check_header(const geofile_header& h, long long size, long long maxPoints)
+{
+	if (size < (long long)sizeof(geofile_header) || memcmp(h.magic, GEOFILE_MAGIC, sizeof(h.magic)) != 0 || h.version != GEOFILE_VERSION || (h.flags & ~GEOFILE_COMPACT) != 0)
+		return false;
+
+	if (h.pointCount < 0 || h.pointCount > maxPoints || h.pointCount > LLONG_MAX / (long long)sizeof(int)
+		|| h.layerCount < 0 || h.layerCount >= INT_MAX || h.layerIndexCount < 0 || h.layerIndexCount > INT_MAX || h.halfedgeCount < 0 || h.halfedgeCount > INT_MAX || h.halfedgeCount % 3 != 0)
+		return false;
+
+	//every section has to fit in the file, and the sections that go together have to be there together
+	long long coordBytes = h.pointCount * ((h.flags & GEOFILE_COMPACT) ? sizeof(unsigned short) : sizeof(int));
+	return section_fits(h, size, GEO_X, coordBytes) && section_fits(h, size, GEO_Y, coordBytes)
+		&& section_fits(h, size, GEO_LAYER_START, (h.layerCount + 1) * sizeof(int)) && section_fits(h, size, GEO_LAYER_INDEX, h.layerIndexCount * sizeof(int))
+		&& section_fits(h, size, GEO_ORIGIN, h.halfedgeCount * sizeof(int)) && section_fits(h, size, GEO_TWIN, h.halfedgeCount * sizeof(int))
+		&& (h.offset[GEO_X] == 0) == (h.offset[GEO_Y] == 0) && (h.offset[GEO_LAYER_START] == 0) == (h.offset[GEO_LAYER_INDEX] == 0)
+		&& (h.offset[GEO_ORIGIN] == 0) == (h.offset[GEO_TWIN] == 0);
+}
+
+//this method returns a pointer to section s of the open file, or NULL when the file doesn't have it
+static const void* section_at(const geofile& f, int s)
+{
+	return f.header->offset[s] == 0 ? NULL : f.data + f.header->offset[s];
+}
+
+//this method checks the header of the open file and fills in the pointers to its sections
+//returns false if the header is not valid, or any section does not fit in the file
+static bool read_header(geofile& f)
+{
+	const geofile_header& h = *f.header;
+	if (!check_header(h, f.size, INT_MAX))
+		return false;
+
+	bool compact = (h.flags & GEOFILE_COMPACT) != 0;
+	const void* xs = section_at(f, GEO_X);
+	const void* ys = section_at(f, GEO_Y);
+	f.layerStart = (const int*)section_at(f, GEO_LAYER_START);
+	f.layerIndex = (const int*)section_at(f, GEO_LAYER_INDEX);
+	f.origin = (const int*)section_at(f, GEO_ORIGIN);
+	f.twin = (const int*)section_at(f, GEO_TWIN);
+
+	f.points = point_view{ (int)h.pointCount, compact, point{ h.originX, h.originY }, NULL, NULL, NULL, NULL };
+	if (compact)
+	{
+		f.points.cx = (const unsigned short*)xs;
+		f.points.cy = (const unsigned short*)ys;
+	}
+	else
+	{
+		f.points.xs = (const int*)xs;
+		f.points.ys = (const int*)ys;
+	}
+
+	//the layers have to stay within the layer index, so they can be read without checking each one
+	if (f.layerStart != NULL)
+	{
+		if (f.layerStart[0] != 0 || f.layerStart[h.layerCount] != h.layerIndexCount)
+			return false;
+		for (long long l = 0; l < h.layerCount; l++)
+			if (f.layerStart[l + 1] < f.layerStart[l])
+				return false;
+	}
+
+	return true;
+}
+
+//this method maps the file at path into memory and checks its header, filling f with pointers to its sections
+//the map is read only, and pages are only read from the disk as the algorithms touch them
+bool geofile_open(geofile& f, const string& path)
+{
+	memset(&f, 0, sizeof(f));
+	if (!little_endian())
+		return false;
+
+#ifdef _WIN32
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER size;
+	HANDLE mapping = NULL;
+	if (GetFileSizeEx(file, &size) && size.QuadPart > 0)
+		mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	CloseHandle(file); //the map keeps the file open
+
+	if (mapping == NULL)
+		return false;
+
+	void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (data == NULL)
+	{
+		CloseHandle(mapping);
+		return false;
+	}
+
+	f.mapping = mapping;
+	f.size = size.QuadPart;
+#else
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+		return false;
+
+	struct stat info;
+	void* data = MAP_FAILED;
+	if (fstat(fd, &info) == 0 && info.st_size > 0)
+		data = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd); //the map keeps the file open
+
+	if (data == MAP_FAILED)
+		return false;
+
+	f.size = info.st_size;
+#endif
+
+	f.data = (const unsigned char*)data;
+	f.header = (const geofile_header*)data;
+
+	if (f.size < (long long)sizeof(geofile_header) || !read_header(f))
+	{
+		geofile_close(f);
+		return false;
+	}
+
+	return true;
+}
+
+//this method unmaps the file, after which the pointers in f, and any views of its points, are no longer valid
+void geofile_close(geofile& f)
+{
+	if (f.data != NULL)
+	{
+#ifdef _WIN32
+		UnmapViewOfFile(f.data);
+		CloseHandle(f.mapping);
+#else
+		munmap((void*)f.data, f.size);
+#endif
+	}
+
+	memset(&f, 0, sizeof(f));
+}
+
+//this method copies the hull layers of the file into layers
+//returns false if any layer vertex is not one of the points
+bool geofile_layers(const geofile& f, vector<vector<int>>& layers)
+{
+	vector<vector<int>>().swap(layers); //clear the layers vector
+	if (f.layerStart == NULL)
+		return true;
+
+	for (long long l = 0; l < f.header->layerCount; l++)
+	{
+		layers.push_back(vector<int>(f.layerIndex + f.layerStart[l], f.layerIndex + f.layerStart[l + 1]));
+		for (int i : layers.back())
+			if (i < 0 || i >= f.points.count)
+				return false;
+	}
+
+	return true;
+}
+
+//this method copies the triangle mesh of the file into m
+//returns false if the file has no coordinates for the mesh vertices, or any half edge refers to a vertex or twin that doesn't exist
+bool geofile_mesh(const geofile& f, halfedge_mesh& m)
+{
+	he_clear(m);
+	if (f.origin == NULL)
+		return true;
+	if (f.points.xs == NULL && f.points.cx == NULL)
+		return false;
+
+	int n = f.points.count, edges = f.header->halfedgeCount;
+	m.points.resize(n);
+	for (int i = 0; i < n; i++)
+		m.points[i] = view_get(f.points, i);
+
+	m.origin.assign(f.origin, f.origin + edges);
+	m.twin.assign(f.twin, f.twin + edges);
+	for (int h = 0; h < edges; h++)
+	{
+		if (m.origin[h] < 0 || m.origin[h] >= n || m.twin[h] < -1 || m.twin[h] >= edges || (m.twin[h] != -1 && m.twin[m.twin[h]] != h))
+		{
+			he_clear(m);
+			return false;
+		}
+	}
+
+	for (int t = 0; t < edges / 3; t++)
+		m.faceEdge.push_back(3 * t);
+
+	return true;
+}
+
+//this method opens the file at path for reading its points a chunk at a time, checking its header
+//returns false if the file cannot be read, is not a valid geometry file, or has no coordinates
+bool geofile_reader_open(geofile_reader& r, const string& path)
+{
+	r.next = 0;
+	r.in.open(path, ios::binary);
+	if (!little_endian() || !r.in || !r.in.seekg(0, ios::end))
+		return false;
+
+	long long size = r.in.tellg();
+	r.in.seekg(0);
+	if (size < (long long)sizeof(geofile_header) || !r.in.read((char*)&r.header, sizeof(r.header)))
+		return false;
+
+	return check_header(r.header, size, LLONG_MAX) && r.header.offset[GEO_X] != 0;
+}
+
+//this method reads one axis of the next n points of the file into the buffer
+static bool read_axis(geofile_reader& r, int s, int n, vector<char>& buffer)
+{
+	long long bytes = (r.header.flags & GEOFILE_COMPACT) ? sizeof(unsigned short) : sizeof(int);
+	buffer.resize(n * bytes);
+
+	return (bool)r.in.seekg(r.header.offset[s] + r.next * bytes) && (n == 0 || r.in.read(buffer.data(), n * bytes));
+}
+
+//this method reads up to n of the next points of the file into points, replacing what was in it
+//returns the number of points read, which is 0 once every point has been read, or -1 if the file could not be read
+int geofile_read(geofile_reader& r, int n, vector<point>& points)
+{
+	n = (int)min((long long)n, r.header.pointCount - r.next);
+	if (!read_axis(r, GEO_X, n, r.xs) || !read_axis(r, GEO_Y, n, r.ys))
+		return -1;
+
+	points.resize(n);
+	if (r.header.flags & GEOFILE_COMPACT)
+	{
+		const unsigned short* cx = (const unsigned short*)r.xs.data();
+		const unsigned short* cy = (const unsigned short*)r.ys.data();
+		for (int i = 0; i < n; i++)
+			points[i] = point{ r.header.originX + cx[i], r.header.originY + cy[i] };
+	}
+	else
+	{
+		const int* xs = (const int*)r.xs.data();
+		const int* ys = (const int*)r.ys.data();
+		for (int i = 0; i < n; i++)
+			points[i] = point{ xs[i], ys[i] };
+	}
+
+	r.next += n;
+	return n;
+}
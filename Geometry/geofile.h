@@ -0,0 +1,110 @@
+/* This is the binary geometry file format, for point sets and for the hull layers and triangle meshes made from them.
+* A file is a fixed header followed by raw little endian arrays (sections), each one starting on a 64 byte boundary.
+* Reading a file maps it into memory, and its points are used in place through a point view (see store.h), so a file is never parsed or copied,
+* which matters for point sets of tens of gigabytes.
+* The header gives the number of points, layers and half edges, and the offset of each section from the start of the file, or 0 for a section the file doesn't have:
+* x and y hold the coordinates (32-bit ints, or 16-bit offsets from the origin when the file is compact),
+* layer start and layer index hold the hull layers as the indices of their vertices, layer l being layer index [start[l], start[l + 1]),
+* and origin and twin hold a triangle half edge mesh, laid out the same way as in halfedge_mesh.
+* The layers index into the points of the file, or when it has no coordinates, into the points of the file they were made from.
+* A file too large to map (or with more points than an int can index) can instead be read a chunk of points at a time with a reader.
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include "geometry.h"
+#include "halfedge.h"
+#include "store.h"
+
+//the bytes every geometry file starts with, and the version of the format this code reads and writes
+const char GEOFILE_MAGIC[8] = { 'G', 'E', 'O', 'M', 'B', 'I', 'N', 0 };
+const unsigned int GEOFILE_VERSION = 1;
+
+//the flags in the header of a geometry file
+const unsigned int GEOFILE_COMPACT = 1; //the coordinates are 16-bit offsets from the origin
+
+//the alignment of every section from the start of the file, enough for any vector load
+const int GEOFILE_ALIGN = 64;
+
+//enums for the sections of a geometry file
+enum {
+	GEO_X, GEO_Y, GEO_LAYER_START, GEO_LAYER_INDEX, GEO_ORIGIN, GEO_TWIN, GEO_SECTIONS
+};
+
+//the header of a geometry file, which is 104 bytes with no padding, written as it is in memory
+typedef struct
+{
+	char magic[8]; //GEOFILE_MAGIC
+	unsigned int version; //GEOFILE_VERSION
+	unsigned int flags; //GEOFILE_COMPACT when the coordinates are 16-bit offsets
+	int originX, originY; //the point the offsets are from, (0, 0) when the file is not compact
+	long long pointCount; //the number of points, which the layers and the mesh index into
+	long long layerCount; //the number of hull layers
+	long long layerIndexCount; //the number of vertices in all the layers together
+	long long halfedgeCount; //the number of half edges in the mesh, three for each triangle
+	long long offset[GEO_SECTIONS]; //the offset of each section from the start of the file, 0 when the file doesn't have it
+} geofile_header;
+
+//the open geometry file structure, a read only memory map of the file with pointers to each of its sections
+typedef struct
+{
+	const unsigned char* data; //the start of the map, NULL when no file is open
+	long long size; //the size of the file in bytes
+	void* mapping; //the handle of the map on windows, unused elsewhere
+	const geofile_header* header; //the header at the start of the file
+	point_view points; //the points of the file, with no coordinate arrays when the file doesn't have them
+	const int* layerStart; //the start of each layer in layerIndex, and the end of the last one, NULL when the file has no layers
+	const int* layerIndex; //the vertices of every layer, one after the other
+	const int* origin; //the vertex each half edge of the mesh starts from, NULL when the file has no mesh
+	const int* twin; //the twin of each half edge of the mesh, or -1 on the boundary
+} geofile;
+
+//this method checks if the file at path starts with GEOFILE_MAGIC, telling a geometry file apart from a text point file
+bool geofile_check(const std::string& path);
+
+//this method maps the file at path into memory and checks its header, filling f with pointers to its sections
+//returns false if the file cannot be mapped or is not a valid geometry file, in which case f has no file open
+bool geofile_open(geofile& f, const std::string& path);
+
+//this method unmaps the file, after which the pointers in f, and any views of its points, are no longer valid
+void geofile_close(geofile& f);
+
+//this method copies the hull layers of the file into layers
+//returns false if any layer vertex is not one of the points
+bool geofile_layers(const geofile& f, std::vector<std::vector<int>>& layers);
+
+//this method copies the triangle mesh of the file into m
+//returns false if the file has no coordinates for the mesh vertices, or any half edge refers to a vertex or twin that doesn't exist
+bool geofile_mesh(const geofile& f, halfedge_mesh& m);
+
+//this method writes the points in the view to a geometry file at path, compact if the view is compact
+//returns false if the file cannot be written
+bool geofile_write_points(const std::string& path, const point_view& v);
+
+//this method writes hull layers, given as indices into a set of pointCount points, to a geometry file at path with no coordinates
+//returns false if the file cannot be written
+bool geofile_write_layers(const std::string& path, int pointCount, const std::vector<std::vector<int>>& layers);
+
+//this method writes the triangle mesh to a geometry file at path, with its points, which are compact if they fit in STORE_COMPACT_RANGE
+//returns false if the mesh is not a triangle mesh or the file cannot be written
+bool geofile_write_mesh(const std::string& path, const halfedge_mesh& m);
+
+//the geometry file reader structure, which reads the points of a file a chunk at a time instead of mapping the whole file
+typedef struct
+{
+	std::ifstream in; //the open file
+	geofile_header header; //the header of the file
+	long long next; //the index of the next point to read
+	std::vector<char> xs, ys; //the raw coordinates of the last chunk read
+} geofile_reader;
+
+//this method opens the file at path for reading its points a chunk at a time, checking its header
+//returns false if the file cannot be read, is not a valid geometry file, or has no coordinates
+bool geofile_reader_open(geofile_reader& r, const std::string& path);
+
+//this method reads up to n of the next points of the file into points, replacing what was in it
+//returns the number of points read, which is 0 once every point has been read, or -1 if the file could not be read
+int geofile_read(geofile_reader& r, int n, std::vector<point>& points);
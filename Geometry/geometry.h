@@ -0,0 +1,17 @@
+/* These are the basic geometry structures shared by the 2D hull peeler, the 2D triangulation and the batch tool.
+* Points are integer coordinates, and everything built from them (hull rings, meshes) refers to them by index.
+*/
+
+#pragma once
+
+//the point structure
+typedef struct
+{
+	int x, y; //x and y coordinates within the window
+} point;
+
+//this method compares two points by x, then by y, giving the order the monotone chain and the sweep walk the points in
+inline bool point_less(point p1, point p2)
+{
+	return p1.x < p2.x || (p1.x == p2.x && p1.y < p2.y);
+}
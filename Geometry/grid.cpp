@@ -0,0 +1,174 @@
+/* This is the implementation of the uniform grid and the clustering built on it.
+* See grid.h for how the grid is laid out.
+*/
+
+#include <algorithm>
+#include <queue>
+#include <climits>
+#include <cmath>
+#include "grid.h"
+#include "predicates.h"
+using namespace std;
+
+//this method builds a grid over the given points
+//the cell size is picked so there are about two points in each cell
+void grid_build(grid& g, const vector<point>& points)
+{
+	//find the extents of the points
+	int xMin = INT_MAX, xMax = INT_MIN, yMin = INT_MAX, yMax = INT_MIN;
+	for (const point& p : points)
+	{
+		xMin = min(p.x, xMin);
+		xMax = max(p.x, xMax);
+		yMin = min(p.y, yMin);
+		yMax = max(p.y, yMax);
+	}
+
+	//set up the grid dimensions, making sure there is at least one cell
+	long long w = points.empty() ? 1 : (long long)xMax - xMin + 1;
+	long long h = points.empty() ? 1 : (long long)yMax - yMin + 1;
+	g.minX = points.empty() ? 0 : xMin;
+	g.minY = points.empty() ? 0 : yMin;
+	//the cell size is worked out in long long, as a few points spread over the full int range need cells wider than an int
+	long long cellSize = (long long)sqrt((double)w * h / max((size_t)1, points.size() / 2));
+	g.cellSize = (int)min(max(cellSize, 1LL), (long long)INT_MAX);
+	g.cols = (int)(w / g.cellSize) + 1;
+	g.rows = (int)(h / g.cellSize) + 1;
+
+	vector<vector<int>>(g.cols * g.rows).swap(g.cells);
+	g.cellOf.assign(points.size(), -1);
+	g.slot.assign(points.size(), -1);
+
+	//add every point to the cell it falls in
+	for (int i = 0; i < points.size(); i++)
+	{
+		//the offsets from the corner can be past INT_MAX, so they are taken in long long before dividing down to cells
+		int c = (int)(((long long)points[i].y - g.minY) / g.cellSize) * g.cols + (int)(((long long)points[i].x - g.minX) / g.cellSize);
+		g.cellOf[i] = c;
+		g.slot[i] = g.cells[c].size();
+		g.cells[c].push_back(i);
+	}
+}
+
+//this method removes the point with index i from the grid
+//the last point in the cell is moved into its slot, so nothing else in the cell has to move
+void grid_remove(grid& g, int i)
+{
+	int c = g.cellOf[i];
+	if (c == -1)
+		return;
+
+	int last = g.cells[c].back();
+	g.cells[c][g.slot[i]] = last;
+	g.slot[last] = g.slot[i];
+	g.cells[c].pop_back();
+
+	g.cellOf[i] = -1;
+	g.slot[i] = -1;
+}
+
+//this method finds the k points in the grid that are nearest to p, filling nearest with their indices from nearest to furthest
+//the cells are searched in rings around the cell containing p, keeping the k closest points found so far
+//once k points are found and the next ring of cells is further away than the kth point, no closer points can exist so the search stops
+//ties in distance go to the smaller index
+void grid_nearest(const grid& g, const vector<point>& points, point p, int k, vector<int>& nearest)
+{
+	vector<int>().swap(nearest); //clear the nearest vector
+	if (k <= 0)
+		return;
+
+	//the k closest points found so far, with the furthest of them on top
+	//the distances are compared exactly, as their squares can be past the range of a long long over the full int range
+	auto further = [&](int i, int j)
+	{
+		int c = compare_length(p, points[i], p, points[j]);
+		return c != 0 ? c < 0 : i < j;
+	};
+	priority_queue<int, vector<int>, decltype(further)> best(further);
+
+	int cx = (int)min(max(((long long)p.x - g.minX) / g.cellSize, 0LL), (long long)g.cols - 1);
+	int cy = (int)min(max(((long long)p.y - g.minY) / g.cellSize, 0LL), (long long)g.rows - 1);
+	int maxRing = max(max(cx, g.cols - 1 - cx), max(cy, g.rows - 1 - cy));
+
+	for (int r = 0; r <= maxRing; r++)
+	{
+		//go through the cells on the border of the ring that are within the grid
+		for (int y = max(cy - r, 0); y <= min(cy + r, g.rows - 1); y++)
+		{
+			//the top and bottom rows of the ring are full, the rest only have the two end cells
+			int step = (y == cy - r || y == cy + r) ? 1 : 2 * r;
+			for (int x = cx - r; x <= cx + r; x += max(step, 1))
+			{
+				if (x < 0 || x >= g.cols)
+					continue;
+
+				for (int i : g.cells[y * g.cols + x])
+				{
+					if (best.size() < k)
+						best.push(i);
+					else if (further(i, best.top()))
+					{
+						best.pop();
+						best.push(i);
+					}
+				}
+			}
+		}
+
+		//any point in the next ring is at least r cells away from p
+		//dx^2 + dy^2 - reach^2 is (dx - reach)(dx + reach) + dy^2, which det2 works out exactly
+		long long reach = (long long)r * g.cellSize;
+		if (best.size() == k)
+		{
+			long long dx = (long long)points[best.top()].x - p.x, dy = (long long)points[best.top()].y - p.y;
+			if (det2(dx - reach, -dy, dy, dx + reach) <= 0)
+				break;
+		}
+	}
+
+	//empty the queue into the nearest vector, then flip it so the closest point is first
+	while (!best.empty())
+	{
+		nearest.push_back(best.top());
+		best.pop();
+	}
+	reverse(nearest.begin(), nearest.end());
+}
+
+//this method splits the points into up to the given number of clusters of size points each, filling groups with the indices of the points in each
+//a grid is built over the points, then the first point that has not been clustered is used as the centre of the next cluster
+//the nearest size points to it are found with the grid and removed from it, so they cannot be in another cluster
+//the indices of the points that did not make it into a cluster are put in leftover, in their original order
+void make_clusters(const vector<point>& points, int clusters, int size, vector<vector<int>>& groups, vector<int>& leftover)
+{
+	vector<vector<int>>().swap(groups); //clear the groups vector
+	vector<int>().swap(leftover); //clear the leftover vector
+
+	//initialize variables
+	vector<int> nearest;
+	grid g;
+	int next = 0;
+
+	grid_build(g, points);
+
+	for (int i = 0; i < clusters; i++)
+	{
+		//find the first point that is not in a cluster yet, stopping if there are none left
+		while (next < points.size() && g.cellOf[next] == -1)
+			next++;
+		if (next == points.size())
+			break;
+
+		//take the closest size points out of the grid as the next cluster
+		grid_nearest(g, points, points[next], size, nearest);
+		for (int j : nearest)
+			grid_remove(g, j);
+
+		groups.push_back(nearest);
+	}
+
+	//keep the points that were not added to a cluster
+	for (int j = 0; j < points.size(); j++)
+		if (g.cellOf[j] != -1)
+			leftover.push_back(j);
+}
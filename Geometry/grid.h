@@ -0,0 +1,33 @@
+/* This is a uniform grid over a set of points, used to find the points nearest to a location without checking every point.
+* The cluster peel uses it to split the points into clusters of the nearest points to a seed.
+*/
+
+#pragma once
+
+#include <vector>
+#include "geometry.h"
+
+//the spatial grid structure
+//points are bucketed into square cells so the nearest points to a location can be found by only searching the cells around it
+typedef struct
+{
+	int minX, minY; //the bottom left corner of the grid
+	int cellSize; //the width and height of each cell
+	int cols, rows; //the number of cells across and up the grid
+	std::vector<std::vector<int>> cells; //the indices of the points in each cell
+	std::vector<int> cellOf; //the cell each point is in, or -1 once it has been removed
+	std::vector<int> slot; //where each point is within its cell, so it can be removed in O(1)
+} grid;
+
+//this method builds a grid over the given points
+void grid_build(grid& g, const std::vector<point>& points);
+
+//this method removes the point with index i from the grid
+void grid_remove(grid& g, int i);
+
+//this method finds the k points in the grid that are nearest to p, filling nearest with their indices from nearest to furthest
+void grid_nearest(const grid& g, const std::vector<point>& points, point p, int k, std::vector<int>& nearest);
+
+//this method splits the points into up to the given number of clusters of size points each, filling groups with the indices of the points in each
+//the indices of the points that did not make it into a cluster are put in leftover
+void make_clusters(const std::vector<point>& points, int clusters, int size, std::vector<std::vector<int>>& groups, std::vector<int>& leftover);
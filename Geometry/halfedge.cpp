@@ -0,0 +1,177 @@
+/* This is the implementation of the indexed half edge mesh.
+* See halfedge.h for how the mesh is laid out.
+*/
+
+#include <algorithm>
+#include "halfedge.h"
+using namespace std;
+
+//this method clears the mesh, getting rid of its contents and freeing its memory
+void he_clear(halfedge_mesh& m)
+{
+	vector<point>().swap(m.points);
+	vector<int>().swap(m.origin);
+	vector<int>().swap(m.twin);
+	vector<int>().swap(m.next);
+	vector<int>().swap(m.face);
+	vector<int>().swap(m.faceEdge);
+}
+
+//this method empties the mesh but keeps the memory of its arrays
+void he_reset(halfedge_mesh& m)
+{
+	m.points.clear();
+	m.origin.clear();
+	m.twin.clear();
+	m.next.clear();
+	m.face.clear();
+	m.faceEdge.clear();
+}
+
+//this method returns the number of faces in the mesh
+int he_face_count(const halfedge_mesh& m)
+{
+	return m.faceEdge.size();
+}
+
+//this method returns the half edge before h around its face, walking around the face when it is not a triangle
+int he_prev(const halfedge_mesh& m, int h)
+{
+	if (m.next.empty())
+		return h - h % 3 + (h + 2) % 3;
+
+	int p = h;
+	while (m.next[p] != h)
+		p = m.next[p];
+
+	return p;
+}
+
+//this method sets half edges h1 and h2 as each other's twin, either one can be -1 to mark the other as a boundary
+void he_set_twin(halfedge_mesh& m, int h1, int h2)
+{
+	if (h1 != -1)
+		m.twin[h1] = h2;
+	if (h2 != -1)
+		m.twin[h2] = h1;
+}
+
+//this method adds a triangle made of the vertices a, b and c to the mesh, with no twins, returning the index of the face
+//if the mesh already has polygon faces, the next and face links are filled for the new half edges too
+int he_add_triangle(halfedge_mesh& m, int a, int b, int c)
+{
+	int f = m.faceEdge.size();
+	int h = m.origin.size();
+
+	m.faceEdge.push_back(h);
+	m.origin.push_back(a);
+	m.origin.push_back(b);
+	m.origin.push_back(c);
+	m.twin.insert(m.twin.end(), 3, -1);
+
+	if (!m.next.empty())
+	{
+		for (int i = 0; i < 3; i++)
+		{
+			m.next.push_back(h + (i + 1) % 3);
+			m.face.push_back(f);
+		}
+	}
+
+	return f;
+}
+
+//this method adds a polygon made of the vertices in verts (in order) to the mesh, with no twins, returning the index of the face
+//the first polygon added fills in the next and face links of all the triangles already in the mesh
+int he_add_polygon(halfedge_mesh& m, const vector<int>& verts)
+{
+	//switch the mesh over to stored links if it only had implicit triangles
+	if (m.next.empty())
+	{
+		for (int h = 0; h < m.origin.size(); h++)
+		{
+			m.next.push_back(h - h % 3 + (h + 1) % 3);
+			m.face.push_back(h / 3);
+		}
+	}
+
+	int f = m.faceEdge.size();
+	int h = m.origin.size();
+
+	m.faceEdge.push_back(h);
+	for (int i = 0; i < verts.size(); i++)
+	{
+		m.origin.push_back(verts[i]);
+		m.twin.push_back(-1);
+		m.next.push_back(h + (i + 1) % verts.size());
+		m.face.push_back(f);
+	}
+
+	return f;
+}
+
+//this method copies the points in ring (indices into points) into the mesh as new vertices, then adds them as a polygon face
+int he_add_ring(halfedge_mesh& m, const vector<point>& points, const vector<int>& ring)
+{
+	vector<int> verts(ring.size());
+	for (int i = 0; i < ring.size(); i++)
+	{
+		verts[i] = m.points.size();
+		m.points.push_back(points[ring[i]]);
+	}
+
+	return he_add_polygon(m, verts);
+}
+
+//this method matches up the twins of all half edges in the mesh by their end points
+//every half edge is sorted by its lower then higher vertex, so the two half edges of an edge end up next to each other
+void he_link_twins(halfedge_mesh& m)
+{
+	vector<int> order(m.origin.size());
+	for (int h = 0; h < order.size(); h++)
+	{
+		order[h] = h;
+		m.twin[h] = -1;
+	}
+
+	//the key of a half edge is its two vertices, lowest first
+	auto key = [&](int h) { int a = m.origin[h], b = he_target(m, h); return make_pair(min(a, b), max(a, b)); };
+	sort(order.begin(), order.end(), [&](int h1, int h2) { return key(h1) < key(h2); });
+
+	//pair up neighbouring half edges that share a key and go opposite ways
+	for (int i = 0; i + 1 < order.size(); i++)
+	{
+		int h1 = order[i], h2 = order[i + 1];
+		if (key(h1) == key(h2) && m.origin[h1] == he_target(m, h2))
+		{
+			he_set_twin(m, h1, h2);
+			i++;
+		}
+	}
+}
+
+//this method flips the edge of half edge h in a triangle mesh
+//the six half edges of the two triangles are rewritten in place, and the twins of the four outside edges are pointed at their new slots
+void he_flip(halfedge_mesh& m, int h)
+{
+	int g = m.twin[h];
+	int t = h - h % 3, n = g - g % 3;
+	int e = h % 3, f = g % 3;
+
+	//the edge goes from a to b, with c opposite it in t and d opposite it in n
+	int a = m.origin[h], b = m.origin[t + (e + 1) % 3], c = m.origin[t + (e + 2) % 3];
+	int d = m.origin[n + (f + 2) % 3];
+
+	//the twins of the four outside edges of the quad a d b c
+	int tad = m.twin[n + (f + 1) % 3], tdb = m.twin[n + (f + 2) % 3];
+	int tbc = m.twin[t + (e + 1) % 3], tca = m.twin[t + (e + 2) % 3];
+
+	m.origin[t] = c; m.origin[t + 1] = a; m.origin[t + 2] = d;
+	m.origin[n] = c; m.origin[n + 1] = d; m.origin[n + 2] = b;
+
+	he_set_twin(m, t, tca);
+	he_set_twin(m, t + 1, tad);
+	he_set_twin(m, t + 2, n);
+	he_set_twin(m, n + 1, tdb);
+	he_set_twin(m, n + 2, tbc);
+}
@@ -0,0 +1,73 @@
+/* This is an indexed half edge mesh, used for the output of both the convex hull and the triangulation.
+* Every face is a loop of half edges, and each half edge stores the 32-bit index of the vertex it starts from in a single point array.
+* The links are stored as separate arrays (struct of arrays) so each one can be scanned on its own.
+* Triangle faces are stored implicitly: half edges 3f, 3f + 1 and 3f + 2 make up face f, so only the origin and twin arrays are needed.
+* Polygon faces (like hull layers) also store their next and face links, which are filled for every half edge once the mesh has one.
+*/
+
+#pragma once
+
+#include <vector>
+#include "geometry.h"
+
+//the half edge mesh structure
+typedef struct
+{
+	std::vector<point> points; //the vertices of the mesh
+	std::vector<int> origin; //the vertex each half edge starts from
+	std::vector<int> twin; //the half edge going the other way along the same edge, or -1 on the boundary
+	std::vector<int> next; //the next half edge around the same face, empty when every face is a triangle
+	std::vector<int> face; //the face each half edge is on, empty when every face is a triangle
+	std::vector<int> faceEdge; //the first half edge of each face
+} halfedge_mesh;
+
+//this method clears the mesh, getting rid of its contents and freeing its memory
+void he_clear(halfedge_mesh& m);
+
+//this method empties the mesh but keeps the memory of its arrays, so a mesh that is built again and again (like a triangulation) reuses it rather than allocating
+void he_reset(halfedge_mesh& m);
+
+//this method returns the number of faces in the mesh
+int he_face_count(const halfedge_mesh& m);
+
+//this method returns the half edge after h around its face
+inline int he_next(const halfedge_mesh& m, int h)
+{
+	return m.next.empty() ? h - h % 3 + (h + 1) % 3 : m.next[h];
+}
+
+//this method returns the half edge before h around its face, only O(1) for triangles
+int he_prev(const halfedge_mesh& m, int h);
+
+//this method returns the face that half edge h is on
+inline int he_face(const halfedge_mesh& m, int h)
+{
+	return m.face.empty() ? h / 3 : m.face[h];
+}
+
+//this method returns the vertex that half edge h ends at
+inline int he_target(const halfedge_mesh& m, int h)
+{
+	return m.origin[he_next(m, h)];
+}
+
+//this method sets half edges h1 and h2 as each other's twin, either one can be -1 to mark the other as a boundary
+void he_set_twin(halfedge_mesh& m, int h1, int h2);
+
+//this method adds a triangle made of the vertices a, b and c to the mesh, with no twins, returning the index of the face
+int he_add_triangle(halfedge_mesh& m, int a, int b, int c);
+
+//this method adds a polygon made of the vertices in verts (in order) to the mesh, with no twins, returning the index of the face
+int he_add_polygon(halfedge_mesh& m, const std::vector<int>& verts);
+
+//this method copies the points in ring (indices into points) into the mesh as new vertices, then adds them as a polygon face
+//this is used for hull rings, whose vertices are a small part of the points they came from
+int he_add_ring(halfedge_mesh& m, const std::vector<point>& points, const std::vector<int>& ring);
+
+//this method matches up the twins of all half edges in the mesh by their end points
+void he_link_twins(halfedge_mesh& m);
+
+//this method flips the edge of half edge h in a triangle mesh, where h goes from a to b with c opposite it, and its twin has d opposite it
+//the two triangles are replaced with (c, a, d) and (c, d, b), sharing the new edge c d
+//the face of h keeps (c, a, d) with c a and a d as its half edges 0 and 1, and the face of the twin keeps (c, d, b) with d b and b c as its half edges 1 and 2
+void he_flip(halfedge_mesh& m, int h);
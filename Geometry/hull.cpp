@@ -0,0 +1,1277 @@
+/* This is the implementation of the convex hull algorithms.
+* See hull.h for what each one gives back.
+*/
+
+#include <algorithm>
+#include <thread>
+#include "hull.h"
+#include "predicates.h"
+#include "simd.h"
+#include "pool.h"
+#include "stats.h"
+using namespace std;
+
+//the points of a point view the hull algorithms run on, one structure for each layout
+//the algorithms are templates over the points they read, so with a structure for each layout, reading a point never checks which layout the view has
+typedef struct
+{
+	const point_view& v; //the view, which is wide
+} wide_points;
+
+typedef struct
+{
+	const point_view& v; //the view, which is compact
+} compact_points;
+
+//these methods return point i of a point array or of the points of a view
+static inline point point_at(const vector<point>& points, int i)
+{
+	return points[i];
+}
+
+static inline point point_at(const wide_points& p, int i)
+{
+	return point{ p.v.xs[i], p.v.ys[i] };
+}
+
+static inline point point_at(const compact_points& p, int i)
+{
+	return point{ p.v.origin.x + p.v.cx[i], p.v.origin.y + p.v.cy[i] };
+}
+
+//these methods return the number of points in a point array or in the points of a view
+static inline int point_count(const vector<point>& points)
+{
+	return points.size();
+}
+
+template <typename V>
+static inline int point_count(const V& p)
+{
+	return p.v.count;
+}
+
+//the quick hull working set, holding the coordinates of each point next to its index (struct of arrays)
+//the three arrays are reordered together, so the scans read the coordinates in order rather than jumping around the points
+//the coordinates are either 32-bit, or 16-bit offsets from the origin when the points come from a compact point store
+//the arrays are kept in a hull scratch between runs, so the working set only allocates when it grows past the largest one so far
+template <typename T>
+struct hull_work
+{
+	vector<int>& idx; //the indices of the points
+	vector<T>& xs; //the coordinates of the point at the same position in idx, relative to the origin
+	vector<T>& ys;
+	point origin; //the origin the coordinates are relative to
+	bool simd; //true when every coordinate is within SIMD_COORD_LIMIT, so the vectorized kernel can be used
+};
+
+//these methods copy the coordinates of the points whose indices are in idx into the working set
+//32-bit coordinates are checked against SIMD_COORD_LIMIT, while 16-bit offsets are always small enough for the vectorized kernel
+static void load_work(const vector<point>& points, hull_work<int>& w)
+{
+	for (int k = 0; k < w.idx.size(); k++)
+	{
+		point p = points[w.idx[k]];
+		w.xs[k] = p.x;
+		w.ys[k] = p.y;
+		if (p.x <= -SIMD_COORD_LIMIT || p.x >= SIMD_COORD_LIMIT || p.y <= -SIMD_COORD_LIMIT || p.y >= SIMD_COORD_LIMIT)
+			w.simd = false;
+	}
+}
+
+static void load_work(const wide_points& p, hull_work<int>& w)
+{
+	for (int k = 0; k < w.idx.size(); k++)
+	{
+		int x = p.v.xs[w.idx[k]], y = p.v.ys[w.idx[k]];
+		w.xs[k] = x;
+		w.ys[k] = y;
+		if (x <= -SIMD_COORD_LIMIT || x >= SIMD_COORD_LIMIT || y <= -SIMD_COORD_LIMIT || y >= SIMD_COORD_LIMIT)
+			w.simd = false;
+	}
+}
+
+static void load_work(const compact_points& p, hull_work<unsigned short>& w)
+{
+	w.origin = p.v.origin;
+	for (int k = 0; k < w.idx.size(); k++)
+	{
+		w.xs[k] = p.v.cx[w.idx[k]];
+		w.ys[k] = p.v.cy[w.idx[k]];
+	}
+}
+
+//this method returns point i of the points relative to the origin of the working set
+template <typename P, typename T>
+static inline point local_point(const P& points, const hull_work<T>& w, int i)
+{
+	point p = point_at(points, i);
+	return point{ p.x - w.origin.x, p.y - w.origin.y };
+}
+
+//this method partitions the range [lo, hi) of the working set, moving the points strictly left of the line p1p2 to the front
+//p1 and p2 are relative to the origin of the working set, and the position after the last point moved to the front is returned
+//every point is swapped with the front of the points that are not left, and the front only moves on past points that are left
+//a point that is not left is just swapped with another point that is not left, so the loop needs no branch on which side each point is
+template <typename T>
+static int partition_left(hull_work<T>& w, int lo, int hi, point p1, point p2)
+{
+	int* idx = w.idx.data();
+	T* xs = w.xs.data();
+	T* ys = w.ys.data();
+
+	int mid = lo;
+	for (int i = lo; i < hi; i++)
+	{
+		T x = xs[i], y = ys[i];
+		int id = idx[i];
+		bool left = orient2d(p1, p2, point{ x, y }) > 0;
+
+		xs[i] = xs[mid];
+		ys[i] = ys[mid];
+		idx[i] = idx[mid];
+		xs[mid] = x;
+		ys[mid] = y;
+		idx[mid] = id;
+		mid += left;
+	}
+
+	return mid;
+}
+
+//this method is an implementation of the QuickHull algorithm
+//it works in place on the working set, taking tasks off the stack until there are none left, each one a range of points strictly left of a line
+//all points in the range are iterated through, finding the point with the max distance from the line
+//this scan is nearly all of the work, so it is done by the vectorized farthest_from_line kernel when the coordinates are small enough for it,
+//and otherwise compared exactly with compare_dist
+//ties are broken on the smallest index so the same point is chosen no matter how the range has been reordered
+//if no point is found, that means either all points are interior to the line or there are colinear points
+//that means that i1 i2 is an edge of the hull, so i1 is added to the ring of hull vertices
+//if a point is found, the range is partitioned into the points left of p1pMax, the points left of pMaxp2, and the interior points which are thrown away
+//then a task is pushed for each of the two lines from pMax to the original two points, each with only its own part of the range
+//the second one is pushed first, so the first is hulled before it and the vertices go on the ring in order, the same as if each task recursed
+//the stack is kept on the heap, so a hull with a great many vertices (like points on a circle) can't overflow the call stack
+template <typename P, typename T>
+static void quick_hull(const P& points, hull_work<T>& w, vector<hull_task>& tasks, vector<int>& ring)
+{
+	while (!tasks.empty())
+	{
+		hull_task task = tasks.back();
+		tasks.pop_back();
+		int lo = task.lo, hi = task.hi;
+		STATS_ADD(STAT_HULL_RANGES, 1);
+		STATS_MAX(STAT_HULL_DEPTH, task.depth);
+
+		//if no point is found, add the start of the edge to the ring
+		if (lo == hi)
+		{
+			ring.push_back(task.i1);
+			continue;
+		}
+
+		//initalize the points (relative to the origin of the working set) and the position of the max distance point
+		STATS_ADD(STAT_HULL_SCANNED, hi - lo);
+		point p1 = local_point(points, w, task.i1), p2 = local_point(points, w, task.i2);
+		int at;
+
+		//iterate through the range, finding the max distance point
+		if (w.simd)
+			at = lo + farthest_from_line(&w.xs[lo], &w.ys[lo], &w.idx[lo], hi - lo, p1, p2);
+		else
+		{
+			at = lo;
+			for (int i = lo + 1; i < hi; i++)
+			{
+				int c = compare_dist(p1, p2, point{ w.xs[i], w.ys[i] }, point{ w.xs[at], w.ys[at] });
+
+				if (c > 0 || (c == 0 && w.idx[i] < w.idx[at]))
+					at = i;
+			}
+		}
+
+		int iMax = w.idx[at];
+		point pMax = point{ w.xs[at], w.ys[at] };
+
+		//split the range into points left of p1pMax, then points left of pMaxp2, leaving the interior points at the end
+		int mid = partition_left(w, lo, hi, p1, pMax);
+		int end = partition_left(w, mid, hi, pMax, p2);
+
+		//push the two new lines, the second first so the first is hulled next
+		tasks.push_back(hull_task{ mid, end, iMax, task.i2, task.depth + 1 });
+		tasks.push_back(hull_task{ lo, mid, task.i1, iMax, task.depth + 1 });
+	}
+}
+
+//this method creates a convex hull using the quick hull algorithm, filling ring with the indices of the hull vertices in clockwise order
+//only the points whose indices are in idx are used, and idx is reordered as the hull is built
+//the method copies the coordinates into the working set, then finds the min and max points by x then y, the same ends the monotone chain starts from
+//when those are the same point every point is a copy of it, so there is no hull, just like the monotone chain
+//then the working set is split into the points above and below the line between them
+//then, quick_hull is run on both directions of the line, ensuring we create a top and bottom to the hull
+//the coordinates go in xs and ys, which are resized to fit, and the tasks of quick_hull in tasks, so arrays kept from an earlier hull are reused
+template <typename T, typename P>
+static void quick_hull_of(const P& points, vector<int>& idx, vector<int>& ring, vector<T>& xs, vector<T>& ys, vector<hull_task>& tasks)
+{
+	//if there are less than three points, we cannot create a convex hull so immediately stop
+	if (idx.size() < 3)
+		return;
+
+	STATS_SPAN("quick_hull");
+	STATS_ADD(STAT_HULL_RUNS, 1);
+	xs.resize(idx.size());
+	ys.resize(idx.size());
+	hull_work<T> w = { idx, xs, ys, point{ 0, 0 }, true };
+	load_work(points, w);
+
+	//iterate through all points and find the min and max by x then y, keeping the smallest index of equal points
+	auto less = [&](int a, int b) { return point_less(point{ w.xs[a], w.ys[a] }, point{ w.xs[b], w.ys[b] }); };
+	int kMin = 0, kMax = 0;
+	for (int k = 1; k < idx.size(); k++)
+	{
+		if (less(k, kMin) || (!less(kMin, k) && idx[k] < idx[kMin]))
+			kMin = k;
+		if (less(kMax, k) || (!less(k, kMax) && idx[k] < idx[kMax]))
+			kMax = k;
+	}
+	if (!less(kMin, kMax))
+		return;
+
+	int iMin = idx[kMin], iMax = idx[kMax];
+	point minPoint = point{ w.xs[kMin], w.ys[kMin] }, maxPoint = point{ w.xs[kMax], w.ys[kMax] };
+
+	//split the working set into the points on either side of the line
+	int mid = partition_left(w, 0, idx.size(), minPoint, maxPoint);
+	int end = partition_left(w, mid, idx.size(), maxPoint, minPoint);
+
+	//run quick hull for both directions of the line, the top first
+	tasks.clear();
+	tasks.push_back(hull_task{ mid, end, iMax, iMin, 0 });
+	tasks.push_back(hull_task{ 0, mid, iMin, iMax, 0 });
+	int first = ring.size();
+	quick_hull(points, w, tasks, ring);
+
+	//a point tied for the farthest from a line can be in the middle of a hull edge that is parallel to it, and then it is on the ring between the ends of that edge
+	//so the vertices that are colinear with the ones either side of them are dropped, which leaves the same ring as the monotone chain whatever order the points are in
+	//the min point is always a corner, so it is kept and the ring is walked from it, checking each vertex against the last one kept and the next one
+	if (ring.size() - first > 2)
+	{
+		int kept = first + 1;
+		for (int k = first + 1; k < ring.size(); k++)
+		{
+			int next = k + 1 < ring.size() ? ring[k + 1] : ring[first];
+			if (orient2d(point_at(points, ring[kept - 1]), point_at(points, ring[k]), point_at(points, next)) != 0)
+				ring[kept++] = ring[k];
+		}
+		ring.resize(kept);
+	}
+}
+
+//this method creates a convex hull using the quick hull algorithm, using only the points whose indices are in idx (which is reordered)
+void quick_convex_hull(const vector<point>& points, vector<int>& idx, vector<int>& ring)
+{
+	hull_scratch scratch;
+	quick_hull_of(points, idx, ring, scratch.xs, scratch.ys, scratch.tasks);
+}
+
+//this method builds one half of the monotone chain hull, walking the sorted indices from position first to position last
+//a point is popped off the chain while it does not make a right turn with the new point, so colinear points are left out of the hull
+//a copy of the point at the end of the chain is not added, so the vertex keeps the smallest index of its copies, the same as the quick hull:
+//equal points are in index order, so the top half (walking forward) keeps the copy it has, and the bottom half (walking back) swaps in the new one
+//after the chain is built, all but its last point are added to the ring, as the last point starts the other half
+template <typename P>
+static void monotone_chain(const P& points, const vector<int>& order, int first, int last, int step, vector<int>& chain, vector<int>& ring)
+{
+	chain.clear(); //clear the chain vector before building a new half, keeping its memory for the points of this one
+
+	for (int i = first; i != last + step; i += step)
+	{
+		point p = point_at(points, order[i]), back = chain.empty() ? p : point_at(points, chain.back());
+		if (!chain.empty() && back.x == p.x && back.y == p.y)
+		{
+			if (step < 0)
+				chain.back() = order[i];
+			continue;
+		}
+
+		//pop points off the chain until the last two points and the new point make a right turn
+		while (chain.size() >= 2 && orient2d(point_at(points, chain[chain.size() - 2]), point_at(points, chain[chain.size() - 1]), p) >= 0)
+			chain.pop_back();
+
+		chain.push_back(order[i]);
+	}
+
+	//add the chain to the ring
+	ring.insert(ring.end(), chain.begin(), chain.end() - 1);
+}
+
+//this method sorts the indices by x then y of their points, which is skipped when they are already in that order
+//equal points are kept in index order so the same duplicate always starts the hull
+template <typename P>
+static void sort_order(const P& points, vector<int>& order)
+{
+	auto less = [&](int i, int j)
+	{
+		point pi = point_at(points, i), pj = point_at(points, j);
+		return point_less(pi, pj) || (!point_less(pj, pi) && i < j);
+	};
+	if (!is_sorted(order.begin(), order.end(), less))
+		sort(order.begin(), order.end(), less);
+}
+
+//this method creates a convex hull using the monotone chain algorithm, filling ring with the indices of the hull vertices in clockwise order
+//only the points whose indices are in order are used, and order is sorted as the hull is built
+//the points are sorted by x then y, which is skipped when the points are already in that order (like the coords vector is), making the hull O(n)
+//otherwise the sort makes the hull O(n log n) no matter how the points are distributed
+//the top of the hull is built from the min point to the max point, then the bottom back to the min point, matching the order of the quick hull
+//both halves are built in chain, which can be kept from an earlier hull
+template <typename P>
+static void monotone_hull_of(const P& points, vector<int>& order, vector<int>& ring, vector<int>& chain)
+{
+	//if there are less than three points, we cannot create a convex hull so immediately stop
+	if (order.size() < 3)
+		return;
+
+	STATS_SPAN("monotone_chain");
+	sort_order(points, order);
+
+	//build the top half from left to right, then the bottom half from right to left
+	monotone_chain(points, order, 0, order.size() - 1, 1, chain, ring);
+	monotone_chain(points, order, order.size() - 1, 0, -1, chain, ring);
+}
+
+//this method creates a convex hull using the monotone chain algorithm, using only the points whose indices are in order (which is sorted)
+void monotone_convex_hull(const vector<point>& points, vector<int>& order, vector<int>& ring)
+{
+	vector<int> chain;
+	monotone_hull_of(points, order, ring, chain);
+}
+
+//these methods create a quick hull with the working set that fits the points, 16-bit offsets for a compact view and 32-bit coordinates otherwise
+//the working set is kept in the scratch
+static void quick_hull_for(const vector<point>& points, vector<int>& idx, vector<int>& ring, hull_scratch& scratch)
+{
+	quick_hull_of(points, idx, ring, scratch.xs, scratch.ys, scratch.tasks);
+}
+
+static void quick_hull_for(const wide_points& p, vector<int>& idx, vector<int>& ring, hull_scratch& scratch)
+{
+	quick_hull_of(p, idx, ring, scratch.xs, scratch.ys, scratch.tasks);
+}
+
+static void quick_hull_for(const compact_points& p, vector<int>& idx, vector<int>& ring, hull_scratch& scratch)
+{
+	quick_hull_of(p, idx, ring, scratch.cx, scratch.cy, scratch.tasks);
+}
+
+//this method creates a convex hull of the points whose indices are in idx, using the given algorithm (HULL_QUICK or HULL_MONOTONE)
+//the temporary arrays of either algorithm are kept in the scratch
+template <typename P>
+static void index_hull_of(const P& points, vector<int>& idx, int method, vector<int>& ring, hull_scratch& scratch)
+{
+	if (method == HULL_MONOTONE)
+		monotone_hull_of(points, idx, ring, scratch.upper);
+	else
+		quick_hull_for(points, idx, ring, scratch);
+}
+
+//this method creates a convex hull of the points whose indices are in idx, using the given algorithm (HULL_QUICK or HULL_MONOTONE)
+void index_hull(const vector<point>& points, vector<int>& idx, int method, vector<int>& ring)
+{
+	hull_scratch scratch;
+	index_hull_of(points, idx, method, ring, scratch);
+}
+
+//this method creates a convex hull of the points in the view whose indices are in idx, using the given algorithm (HULL_QUICK or HULL_MONOTONE)
+//the quick hull of a compact view keeps its 16-bit offsets in the working set, so the scans read half as much memory
+void index_hull(const point_view& v, vector<int>& idx, int method, vector<int>& ring)
+{
+	hull_scratch scratch;
+	if (v.compact)
+		index_hull_of(compact_points{ v }, idx, method, ring, scratch);
+	else
+		index_hull_of(wide_points{ v }, idx, method, ring, scratch);
+}
+
+//this method fills oct with the extreme points of the points in [lo, hi) in the eight directions of the Akl-Toussaint filter, in counter clockwise order
+//these are the points with the largest x, x + y, y, y - x and the smallest x, x + y, y, y - x, some of which can be the same point
+//the range must not be empty
+template <typename P>
+static void extreme_octagon(const P& points, int lo, int hi, point oct[8])
+{
+	for (int k = 0; k < 8; k++)
+		oct[k] = point_at(points, lo);
+
+	for (int i = lo; i < hi; i++)
+	{
+		point p = point_at(points, i);
+		long long sum = (long long)p.x + p.y, diff = (long long)p.y - p.x;
+		if (p.x > oct[0].x)
+			oct[0] = p;
+		if (sum > (long long)oct[1].x + oct[1].y)
+			oct[1] = p;
+		if (p.y > oct[2].y)
+			oct[2] = p;
+		if (diff > (long long)oct[3].y - oct[3].x)
+			oct[3] = p;
+		if (p.x < oct[4].x)
+			oct[4] = p;
+		if (sum < (long long)oct[5].x + oct[5].y)
+			oct[5] = p;
+		if (p.y < oct[6].y)
+			oct[6] = p;
+		if (diff < (long long)oct[7].y - oct[7].x)
+			oct[7] = p;
+	}
+}
+
+//this method fills poly with the corners of the filter polygon, taking every extreme point of the octagon, or with a step of 2, only the largest and smallest x and y
+//the repeated corners are dropped, which leaves a convex polygon in counter clockwise order, and the number of corners is returned
+static int filter_corners(const point ext[8], int step, point poly[8])
+{
+	int corners = 0;
+	for (int k = 0; k < 8; k += step)
+		if (corners == 0 || ((ext[k].x != poly[corners - 1].x || ext[k].y != poly[corners - 1].y) && (k + step < 8 || ext[k].x != poly[0].x || ext[k].y != poly[0].y)))
+			poly[corners++] = ext[k];
+
+	return corners;
+}
+
+//this method checks if p is strictly inside the octagon (or any convex polygon of up to eight corners from filter_corners), which is strictly to the left of every edge between two different corners
+//when the octagon is flat (all the candidates are colinear), no point is strictly left of every edge, so nothing is thrown away
+static bool inside_octagon(const point oct[8], int corners, point p)
+{
+	for (int k = 0; k < corners; k++)
+		if (orient2d(oct[k], oct[(k + 1) % corners], p) <= 0)
+			return false;
+
+	return corners >= 3;
+}
+
+//this method finds a box strictly inside the filter polygon, filling box with its min x, max x, min y and max y
+//the box is the bounding box of the corners shrunk towards its center, by less the first time and more each time after, until all four of its corners are strictly inside
+//the polygon is convex, so the whole box is then strictly inside it, and a point in the box can be thrown away without testing it against every edge
+//returns false if no box was found
+static bool filter_box(const point poly[8], int corners, int box[4])
+{
+	long long x0 = poly[0].x, x1 = poly[0].x, y0 = poly[0].y, y1 = poly[0].y;
+	for (int k = 1; k < corners; k++)
+	{
+		x0 = min(x0, (long long)poly[k].x);
+		x1 = max(x1, (long long)poly[k].x);
+		y0 = min(y0, (long long)poly[k].y);
+		y1 = max(y1, (long long)poly[k].y);
+	}
+
+	//the box keeps 15/16, 7/8, 3/4 then 1/2 of the distance from the center to each side
+	long long cx = (x0 + x1) / 2, cy = (y0 + y1) / 2;
+	for (int shift = 4; shift >= 1; shift--)
+	{
+		long long keep = (1LL << shift) - 1, unit = 1LL << shift;
+		box[0] = (int)(cx - (cx - x0) * keep / unit);
+		box[1] = (int)(cx + (x1 - cx) * keep / unit);
+		box[2] = (int)(cy - (cy - y0) * keep / unit);
+		box[3] = (int)(cy + (y1 - cy) * keep / unit);
+
+		if (inside_octagon(poly, corners, point{ box[0], box[2] }) && inside_octagon(poly, corners, point{ box[1], box[2] })
+			&& inside_octagon(poly, corners, point{ box[1], box[3] }) && inside_octagon(poly, corners, point{ box[0], box[3] }))
+			return true;
+	}
+
+	return false;
+}
+
+//this method fills idx with the indices of the points in [lo, hi), leaving out the ones the filter (one of the HULL_FILTER enums) throws away
+//those are the points strictly inside the polygon of the extreme points in the filter's directions, which can't be hull vertices,
+//while the points on its edges stay, as the hulls can pick those when breaking ties
+//returns the number of points left out
+template <typename P>
+static int filter_range(const P& points, int lo, int hi, int filter, vector<int>& idx)
+{
+	idx.clear(); //clear the indices, keeping their memory from the last hull
+
+	point ext[8], poly[8];
+	int corners = 0;
+	if (filter != HULL_FILTER_NONE && hi > lo)
+	{
+		extreme_octagon(points, lo, hi, ext);
+		corners = filter_corners(ext, filter == HULL_FILTER_QUAD ? 2 : 1, poly);
+	}
+
+	if (corners < 3)
+	{
+		for (int i = lo; i < hi; i++)
+			idx.push_back(i);
+		return 0;
+	}
+
+	STATS_SPAN("hull_filter");
+
+	//most of the points thrown away are in the box, which only takes four comparisons, and the rest are tested against the edges
+	int box[4];
+	bool hasBox = filter_box(poly, corners, box);
+	for (int i = lo; i < hi; i++)
+	{
+		point p = point_at(points, i);
+		if (hasBox && p.x >= box[0] && p.x <= box[1] && p.y >= box[2] && p.y <= box[3])
+			continue;
+
+		if (!inside_octagon(poly, corners, p))
+			idx.push_back(i);
+	}
+
+	return hi - lo - idx.size();
+}
+
+//this method creates a convex hull of the points on several threads, filling ring with the indices of the hull vertices in clockwise order
+//the points are split into one chunk for each thread, and each thread finds the hull of its own chunk
+//every point of the full hull is on the hull of its chunk, so the hull of the chunk hull vertices is the full hull
+//the chunk hulls are tiny next to the input, so that last hull is quick, and the threads only read the points, so no locking is needed
+//the candidate indices are sorted before the last hull, so ties are broken on the smallest index the same way the single threaded hull breaks them
+//the only difference from the single threaded hull is that quick hull can keep colinear points along an edge, which a chunk hull may have left out
+//each thread has its own scratch for its chunk, and the scratch given is used for the last hull
+//each thread runs the filter over its own chunk, and the number of points they threw away is returned
+template <typename P>
+static int parallel_hull_of(const P& points, int method, int threads, int filter, vector<int>& ring, hull_scratch& scratch)
+{
+	int n = point_count(points);
+	vector<vector<int>> chunkRings(threads);
+	vector<int> removed(threads);
+	vector<thread> workers;
+
+	//find the hull of each chunk on its own thread
+	for (int t = 0; t < threads; t++)
+	{
+		workers.push_back(thread([&, t]()
+		{
+			STATS_SPAN("hull_chunk");
+			int lo = (long long)n * t / threads, hi = (long long)n * (t + 1) / threads;
+			vector<int> idx;
+			removed[t] = filter_range(points, lo, hi, filter, idx);
+
+			hull_scratch chunkScratch;
+			index_hull_of(points, idx, method, chunkRings[t], chunkScratch);
+
+			//a chunk too small to have a hull passes all its points on
+			if (chunkRings[t].empty())
+				chunkRings[t] = idx;
+		}));
+	}
+
+	for (thread& w : workers)
+		w.join();
+
+	//merge the chunk hulls by finding the hull of their vertices
+	vector<int> candidates;
+	for (const vector<int>& r : chunkRings)
+		candidates.insert(candidates.end(), r.begin(), r.end());
+
+	sort(candidates.begin(), candidates.end());
+	candidates.erase(unique(candidates.begin(), candidates.end()), candidates.end());
+	index_hull_of(points, candidates, method, ring, scratch);
+
+	int total = 0;
+	for (int r : removed)
+		total += r;
+	return total;
+}
+
+//this method creates a convex hull of the points on the given number of threads, merging the hulls of one chunk of points for each thread
+void parallel_convex_hull(const vector<point>& points, int method, int threads, vector<int>& ring)
+{
+	hull_scratch scratch;
+	parallel_hull_of(points, method, threads, HULL_FILTER_NONE, ring, scratch);
+}
+
+//this method creates a convex hull of the points, filling ring with the indices of the hull vertices in clockwise order
+//it does not use the global structure, so it can be called on any points, using up to the given number of threads
+//the hull only goes parallel when each thread would get at least HULL_CHUNK_MIN points, as starting threads costs more than a small hull
+//the indices and the other temporary arrays of a single threaded hull are kept in the scratch
+//the points the filter (one of the HULL_FILTER enums) throws away are never given to the hull, and the number of them is returned
+template <typename P>
+static int compute_hull_of(const P& points, int method, int threads, int filter, vector<int>& ring, hull_scratch& scratch)
+{
+	STATS_SPAN("compute_hull");
+	int n = point_count(points);
+	threads = min(threads, n / HULL_CHUNK_MIN);
+
+	if (threads > 1)
+		return parallel_hull_of(points, method, threads, filter, ring, scratch);
+
+	int removed = filter_range(points, 0, n, filter, scratch.idx);
+	index_hull_of(points, scratch.idx, method, ring, scratch);
+	return removed;
+}
+
+//this method creates a convex hull of the points, filling ring with the indices of the hull vertices, using up to the given number of threads
+void compute_hull(const vector<point>& points, int method, int threads, vector<int>& ring)
+{
+	hull_scratch scratch;
+	compute_hull_of(points, method, threads, HULL_FILTER_NONE, ring, scratch);
+}
+
+//this method creates a convex hull of the points in the view, filling ring with the indices of the hull vertices, using up to the given number of threads
+void compute_hull(const point_view& v, int method, int threads, vector<int>& ring)
+{
+	hull_scratch scratch;
+	compute_hull(v, method, threads, ring, scratch);
+}
+
+//this method creates a convex hull of the points the same way, keeping its temporary arrays in the scratch
+void compute_hull(const vector<point>& points, int method, int threads, vector<int>& ring, hull_scratch& scratch)
+{
+	compute_hull_of(points, method, threads, HULL_FILTER_NONE, ring, scratch);
+}
+
+//this method creates a convex hull of the points in the view the same way, keeping its temporary arrays in the scratch
+void compute_hull(const point_view& v, int method, int threads, vector<int>& ring, hull_scratch& scratch)
+{
+	filtered_hull(v, method, threads, HULL_FILTER_NONE, ring, scratch);
+}
+
+//this method creates a convex hull of the points the same way, first throwing away the points the filter finds strictly inside the polygon of the extreme points
+//returns the number of points thrown away
+int filtered_hull(const vector<point>& points, int method, int threads, int filter, vector<int>& ring, hull_scratch& scratch)
+{
+	return compute_hull_of(points, method, threads, filter, ring, scratch);
+}
+
+//this method creates a convex hull of the points in the view the same way, first throwing away the points the filter finds strictly inside the polygon of the extreme points
+//returns the number of points thrown away
+int filtered_hull(const point_view& v, int method, int threads, int filter, vector<int>& ring, hull_scratch& scratch)
+{
+	if (v.compact)
+		return compute_hull_of(compact_points{ v }, method, threads, filter, ring, scratch);
+	else
+		return compute_hull_of(wide_points{ v }, method, threads, filter, ring, scratch);
+}
+
+//this method builds one half of a hull layer out of the sorted indices of the points that have not been peeled yet
+//this works the same as monotone_chain, but colinear points are kept so the points along the edges become part of the layer
+template <typename P>
+static void layer_chain(const P& points, const vector<int>& alive, int first, int last, int step, vector<int>& chain)
+{
+	chain.clear(); //clear the chain vector before building a new half, keeping its memory for the points of this one
+
+	for (int i = first; i != last + step; i += step)
+	{
+		//pop points off the chain until the last two points and the new point make a right turn or are colinear
+		point p = point_at(points, alive[i]);
+		while (chain.size() >= 2 && orient2d(point_at(points, chain[chain.size() - 2]), point_at(points, chain[chain.size() - 1]), p) > 0)
+			chain.pop_back();
+
+		chain.push_back(alive[i]);
+	}
+}
+
+//this method builds the hull layer of the sorted indices of the points that have not been peeled yet, in the same clockwise order as the quick hull
+//the layer is the top half followed by the bottom half without its end points, skipping points the top half already has (when all points are colinear)
+//each point put on the layer is marked as peeled, and the two halves are built in upper and lower
+template <typename P>
+static void layer_of(const P& points, const vector<int>& alive, vector<int>& upper, vector<int>& lower, vector<char>& peeled, vector<int>& layer)
+{
+	layer_chain(points, alive, 0, alive.size() - 1, 1, upper);
+	layer_chain(points, alive, alive.size() - 1, 0, -1, lower);
+
+	for (int i : upper)
+	{
+		layer.push_back(i);
+		peeled[i] = true;
+	}
+	for (int i = 1; i + 1 < lower.size(); i++)
+	{
+		if (!peeled[lower[i]])
+		{
+			layer.push_back(lower[i]);
+			peeled[lower[i]] = true;
+		}
+	}
+}
+
+//enums for a node of a peel tree that has no bridge, which are kept where the node would keep the left end of its bridge
+enum {
+	PEEL_LEFT = -1, PEEL_RIGHT = -2, PEEL_EMPTY = -3, PEEL_LEAF = -4
+};
+
+//the peel tree structure, one half of the hull of the points the peel has not taken yet, kept in a tree over the sorted points (the hull tree of Overmars and van Leeuwen)
+//each node covers a range of the sorted positions, and its half is the half of its left child up to the left end of its bridge, then the half of its right child from the right end on
+//so a node only keeps its bridge (as two positions), or PEEL_LEFT or PEEL_RIGHT when only one of its children has points left, PEEL_EMPTY when neither does, and PEEL_LEAF for a point
+//a half keeps the colinear points along its edges, so they become part of the layer the same as its corners, by taking the bridge from the last point on its line in the left child to the first one in the right child
+//the nodes are in pre order, so the children of node v covering [lo, hi) are v + 1 covering [lo, mid) and v + 2 (mid - lo) covering [mid, hi), which is 2n - 1 nodes for n points
+//the lower half is the same tree over the sorted points in reverse, as the bottom chain walked back from the max point is a top chain of the points in that order
+typedef struct
+{
+	const vector<int>* order; //the sorted indices of the points
+	bool reverse; //true for the lower half, whose positions run back from the end of the sorted indices
+	vector<int>* bridges; //the two ends of the bridge of each node, two ints for each
+} peel_tree;
+
+//this method returns the point at the given position of the peel tree
+template <typename P>
+static inline point tree_point(const P& points, const peel_tree& t, int pos)
+{
+	const vector<int>& order = *t.order;
+	return point_at(points, order[t.reverse ? order.size() - 1 - pos : pos]);
+}
+
+//this method searches the half of node v (covering [lo, hi)) for a point, going down one node at a time, and returns its position
+//each step tests the bridge of the node as an edge of the half, and goRight(a, b) says if the point is after the edge a b (at b or past it) rather than at a or before it
+//the part of the half under a node is the half of that node cut down to the range of positions [from, to], and a bridge outside of it is not one of its edges,
+//so the search goes straight into the child holding the whole part instead, which makes it O(log n)
+template <typename P, typename F>
+static int tree_search(const P& points, const peel_tree& t, int v, int lo, int hi, F goRight)
+{
+	const int* b = t.bridges->data();
+	int from = lo, to = hi - 1;
+	while (hi - lo > 1)
+	{
+		int mid = (lo + hi) / 2, l = b[2 * v], r = b[2 * v + 1];
+		bool right;
+		if (l == PEEL_RIGHT || (l >= 0 && l < from))
+			right = true;
+		else if (l == PEEL_LEFT || (l >= 0 && r > to))
+			right = false;
+		else
+			right = goRight(tree_point(points, t, l), tree_point(points, t, r));
+
+		if (right)
+		{
+			if (l >= 0)
+				from = max(from, r);
+			v += 2 * (mid - lo);
+			lo = mid;
+		}
+		else
+		{
+			if (l >= 0)
+				to = min(to, l);
+			v++;
+			hi = mid;
+		}
+	}
+
+	return lo;
+}
+
+//this method works out the bridge of node v (covering [lo, hi)) from the halves of its children
+//the left end is found with a search of the left half, which at each edge a1 a2 finds the point the line from a1 touches the right half at (with a search of the right half),
+//and goes on past the edge when a2 is above that line or on it, so the left end is the last point on the bridge line, then the right end is where the line from it touches the right half
+//the line from a point touches the right half at the first point whose next edge it is not above, so the right end is the first point on the bridge line
+//this is O(log^2 n) for the node
+template <typename P>
+static void tree_join(const P& points, const peel_tree& t, int v, int lo, int hi)
+{
+	int mid = (lo + hi) / 2, left = v + 1, right = v + 2 * (mid - lo);
+	int* b = t.bridges->data();
+	bool hasLeft = b[2 * left] != PEEL_EMPTY, hasRight = b[2 * right] != PEEL_EMPTY;
+	if (!hasLeft || !hasRight)
+	{
+		b[2 * v] = hasLeft ? PEEL_LEFT : (hasRight ? PEEL_RIGHT : PEEL_EMPTY);
+		return;
+	}
+
+	int l = tree_search(points, t, left, lo, mid, [&](point a1, point a2)
+	{
+		point touch = tree_point(points, t, tree_search(points, t, right, mid, hi, [&](point c1, point c2) { return orient2d(c1, c2, a1) > 0; }));
+		return orient2d(a1, touch, a2) >= 0;
+	});
+	point from = tree_point(points, t, l);
+	int r = tree_search(points, t, right, mid, hi, [&](point c1, point c2) { return orient2d(c1, c2, from) > 0; });
+
+	b[2 * v] = l;
+	b[2 * v + 1] = r;
+}
+
+//this method builds the peel tree under node v (covering [lo, hi)), with every point in it
+template <typename P>
+static void tree_build(const P& points, const peel_tree& t, int v, int lo, int hi)
+{
+	if (hi - lo == 1)
+	{
+		(*t.bridges)[2 * v] = PEEL_LEAF;
+		return;
+	}
+
+	int mid = (lo + hi) / 2;
+	tree_build(points, t, v + 1, lo, mid);
+	tree_build(points, t, v + 2 * (mid - lo), mid, hi);
+	tree_join(points, t, v, lo, hi);
+}
+
+//this method takes the count points at the sorted positions in gone out of the peel tree under node v (covering [lo, hi))
+//only the nodes above a point taken out are joined again, bottom up, so a layer of k points costs O(k log^3 n) at the very most, and far less when its points share nodes
+template <typename P>
+static void tree_remove(const P& points, const peel_tree& t, int v, int lo, int hi, const int* gone, int count)
+{
+	if (count == 0)
+		return;
+
+	if (hi - lo == 1)
+	{
+		(*t.bridges)[2 * v] = PEEL_EMPTY;
+		return;
+	}
+
+	int mid = (lo + hi) / 2;
+	int split = lower_bound(gone, gone + count, mid) - gone;
+	tree_remove(points, t, v + 1, lo, mid, gone, split);
+	tree_remove(points, t, v + 2 * (mid - lo), mid, hi, gone + split, count - split);
+	tree_join(points, t, v, lo, hi);
+}
+
+//this method adds the positions of the points of the half of node v (covering [lo, hi)) that are in [from, to] to chain, in order
+//each point costs O(log n) to reach, as only the nodes with some of the half under them are gone into
+static void tree_chain(const peel_tree& t, int v, int lo, int hi, int from, int to, vector<int>& chain)
+{
+	const int* b = t.bridges->data();
+	int l = b[2 * v], r = b[2 * v + 1];
+	if (hi - lo == 1)
+	{
+		if (l == PEEL_LEAF && from <= lo && lo <= to)
+			chain.push_back(lo);
+		return;
+	}
+
+	int mid = (lo + hi) / 2;
+	if (l == PEEL_LEFT)
+		tree_chain(t, v + 1, lo, mid, from, to, chain);
+	else if (l == PEEL_RIGHT)
+		tree_chain(t, v + 2 * (mid - lo), mid, hi, from, to, chain);
+	else if (l >= 0)
+	{
+		if (from <= l)
+			tree_chain(t, v + 1, lo, mid, from, min(to, l), chain);
+		if (r <= to)
+			tree_chain(t, v + 2 * (mid - lo), mid, hi, max(from, r), to, chain);
+	}
+}
+
+//this method peels all the hull layers of the points, filling layers with the indices of the points in each layer
+//the points are sorted once, then the upper and lower halves of the hull of the points left are kept in two peel trees over the sorted points
+//each layer is the upper half followed by the points of the lower half that are not on it, and its points are then taken out of both trees
+//each layer is in the same clockwise order as the quick hull, starting from the min point, and a set of colinear points makes up a single layer
+//equal points are only peeled once, as the copy with the smallest index, so a layer never has an edge of zero length; the other copies are on no layer
+//this costs O(n log n) for the sort and building the trees, then polylog for each point peeled, rather than a full hull and a scan of all the edges for each layer
+//when there is a progress (it can be NULL), each layer is counted as a step, and the peel stops with no layers if it is cancelled
+//the sorted indices, the peeled marks, the two halves of each layer, the positions taken out and the trees are kept in the scratch
+template <typename P>
+static bool peel_layers_of(const P& points, vector<vector<int>>& layers, job_progress* progress, hull_scratch& scratch)
+{
+	STATS_SPAN("peel");
+	vector<vector<int>>().swap(layers); //clear the layers vector
+
+	//sort the indices of the points by x then y, then drop all but the first copy of equal points
+	vector<int>& order = scratch.idx;
+	{
+		STATS_SPAN("peel_sort");
+		order.resize(point_count(points));
+		for (int i = 0; i < order.size(); i++)
+			order[i] = i;
+		sort_order(points, order);
+		order.erase(unique(order.begin(), order.end(), [&](int i, int j) { return !point_less(point_at(points, i), point_at(points, j)); }), order.end());
+	}
+
+	int n = order.size();
+	if (n < 3)
+		return true;
+
+	//build the two trees over the sorted points
+	peel_tree upper = { &order, false, &scratch.upperTree }, lower = { &order, true, &scratch.lowerTree };
+	{
+		STATS_SPAN("peel_build");
+		scratch.upperTree.resize(2 * (2 * n - 1));
+		scratch.lowerTree.resize(2 * (2 * n - 1));
+		tree_build(points, upper, 0, 0, n);
+		tree_build(points, lower, 0, 0, n);
+	}
+
+	vector<char>& peeled = scratch.peeled;
+	peeled.assign(point_count(points), false);
+	vector<int>& top = scratch.upper;
+	vector<int>& bottom = scratch.lower;
+	vector<int>& gone = scratch.gone;
+
+	//as long as there are at least three points, we can do a convex hull
+	for (int left = n; left > 2; )
+	{
+		top.clear();
+		bottom.clear();
+		tree_chain(upper, 0, 0, n, 0, n - 1, top);
+		tree_chain(lower, 0, 0, n, 0, n - 1, bottom);
+
+		//the layer is the top half followed by the bottom half without its end points, skipping points the top half already has (when all points are colinear)
+		layers.push_back(vector<int>());
+		vector<int>& layer = layers.back();
+		gone.clear();
+		for (int pos : top)
+		{
+			layer.push_back(order[pos]);
+			peeled[order[pos]] = true;
+			gone.push_back(pos);
+		}
+		for (int k = 1; k + 1 < bottom.size(); k++)
+		{
+			int pos = n - 1 - bottom[k];
+			if (!peeled[order[pos]])
+			{
+				layer.push_back(order[pos]);
+				peeled[order[pos]] = true;
+				gone.push_back(pos);
+			}
+		}
+		STATS_ADD(STAT_PEEL_LAYERS, 1);
+
+		//take the layer out of both trees, which need the positions in their own order
+		left -= gone.size();
+		sort(gone.begin(), gone.end());
+		tree_remove(points, upper, 0, 0, n, gone.data(), gone.size());
+		reverse(gone.begin(), gone.end());
+		for (int& pos : gone)
+			pos = n - 1 - pos;
+		tree_remove(points, lower, 0, 0, n, gone.data(), gone.size());
+
+		if (progress != NULL && !job_step(*progress, 1))
+		{
+			vector<vector<int>>().swap(layers);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+//this method peels all the hull layers of the points, filling layers with the indices of the points in each layer
+void peel_layers(const vector<point>& points, vector<vector<int>>& layers)
+{
+	hull_scratch scratch;
+	peel_layers_of(points, layers, NULL, scratch);
+}
+
+//this method peels all the hull layers of the points in the view, filling layers with the indices of the points in each layer
+void peel_layers(const point_view& v, vector<vector<int>>& layers)
+{
+	hull_scratch scratch;
+	if (v.compact)
+		peel_layers_of(compact_points{ v }, layers, NULL, scratch);
+	else
+		peel_layers_of(wide_points{ v }, layers, NULL, scratch);
+}
+
+//this method peels all the hull layers of the points, keeping its temporary arrays in the scratch and counting one step of the progress for each layer peeled
+bool peel_layers(const vector<point>& points, vector<vector<int>>& layers, hull_scratch& scratch, job_progress& progress)
+{
+	return peel_layers_of(points, layers, &progress, scratch);
+}
+
+//the cluster worker structure, what each thread of a cluster peel keeps from one cluster to the next
+typedef struct
+{
+	vector<point> points; //the points of the cluster being peeled
+	hull_scratch scratch; //the temporary arrays of the peel
+} cluster_worker;
+
+//this method peels the clusters on the pool, one cluster at a time as the clusters are large, each thread copying its clusters into its own points
+//the layers of each cluster go into their own slot of layers, so the threads share nothing but the progress,
+//and the layers come out in cluster order whichever thread peeled each cluster
+static bool peel_clusters_of(const vector<point>& points, const vector<vector<int>>& groups, int threads, vector<vector<vector<int>>>& layers, job_progress* progress)
+{
+	STATS_SPAN("peel_clusters");
+	int n = groups.size();
+	threads = max(1, min(threads, n));
+	vector<cluster_worker> workers(threads);
+	vector<vector<vector<int>>>(n).swap(layers);
+
+	pool_run(n, threads, 1, [&](int t, int lo, int hi)
+	{
+		cluster_worker& w = workers[t];
+		for (int c = lo; c < hi; c++)
+		{
+			const vector<int>& group = groups[c];
+			w.points.clear(); //empty the points, keeping their memory for the next cluster
+			for (int i : group)
+				w.points.push_back(points[i]);
+
+			if (!peel_layers_of(w.points, layers[c], progress, w.scratch))
+				return;
+
+			//turn the indices into the cluster back into indices into the points
+			for (vector<int>& layer : layers[c])
+				for (int& i : layer)
+					i = group[i];
+		}
+	});
+
+	if (progress != NULL && progress->cancel.load())
+	{
+		vector<vector<vector<int>>>().swap(layers);
+		return false;
+	}
+	return true;
+}
+
+//this method peels the clusters of the points using up to the given number of threads, filling layers with the hull layers of each cluster
+void peel_clusters(const vector<point>& points, const vector<vector<int>>& groups, int threads, vector<vector<vector<int>>>& layers)
+{
+	peel_clusters_of(points, groups, threads, layers, NULL);
+}
+
+//this method peels the clusters the same way, counting one step of the progress for each layer peeled in any cluster
+bool peel_clusters(const vector<point>& points, const vector<vector<int>>& groups, int threads, vector<vector<vector<int>>>& layers, job_progress& progress)
+{
+	return peel_clusters_of(points, groups, threads, layers, &progress);
+}
+
+//this method creates a convex hull the same way as the first layer of the peel, keeping the colinear points along its edges as hull vertices
+//only the points whose indices are in order are used, and order is sorted as the hull is built (which is skipped when it already is)
+void boundary_convex_hull(const vector<point>& points, vector<int>& order, vector<int>& ring)
+{
+	ring.clear(); //clear the ring vector before filling it
+
+	//if there are less than three points, we cannot create a convex hull so immediately stop
+	if (order.size() < 3)
+		return;
+
+	sort_order(points, order);
+
+	vector<int> upper, lower;
+	vector<char> peeled(points.size(), false);
+	layer_of(points, order, upper, lower, peeled, ring);
+}
+
+//this method clears the online hull, so it holds no points
+void online_hull_clear(online_hull& h)
+{
+	h.top.clear();
+	h.bottom.clear();
+	h.count = 0;
+}
+
+//this method inserts point i into one chain of the online hull, returning true if it became a vertex of the chain
+//turn is -1 for the top chain, which only makes right turns from left to right, and 1 for the bottom chain, which only makes left turns
+//a point between two neighbours of the chain that does not make the turn with them is inside, so it is rejected, just like monotone_chain would pop it
+//otherwise it is added, and any neighbours that no longer make the turn are removed, each of which was only ever added once
+static bool chain_insert(map<point, int, point_order>& chain, point p, int i, int turn)
+{
+	//a point already in the chain is a duplicate, and the first copy is kept
+	map<point, int, point_order>::iterator pos = chain.lower_bound(p);
+	if (pos != chain.end() && !point_less(p, pos->first))
+		return false;
+
+	//a point between the ends of the chain is rejected if it does not make the turn with its neighbours
+	if (pos != chain.begin() && pos != chain.end() && orient2d(prev(pos)->first, p, pos->first) * turn <= 0)
+		return false;
+
+	pos = chain.insert(pos, make_pair(p, i));
+
+	//remove the neighbours after the point that no longer make the turn
+	while (next(pos) != chain.end() && next(next(pos)) != chain.end() && orient2d(p, next(pos)->first, next(next(pos))->first) * turn <= 0)
+		chain.erase(next(pos));
+
+	//remove the neighbours before the point that no longer make the turn
+	while (pos != chain.begin() && prev(pos) != chain.begin() && orient2d(prev(prev(pos))->first, prev(pos)->first, p) * turn <= 0)
+		chain.erase(prev(pos));
+
+	return true;
+}
+
+//this method inserts point i of the points into the online hull, returning true if it became a hull vertex
+//the point is inside the hull when it is inside both chains, which is found with one search of each tree
+bool online_hull_insert(online_hull& h, const vector<point>& points, int i)
+{
+	h.count++;
+
+	bool onTop = chain_insert(h.top, points[i], i, -1);
+	bool onBottom = chain_insert(h.bottom, points[i], i, 1);
+
+	return onTop || onBottom;
+}
+
+//this method starts the online hull from a hull already built from the points, so only the ring vertices need to be inserted
+//points inside that hull can never be hull vertices again, as points are only added, so they are left out of the trees
+//a ring is only empty when there are less than three points, and then they are all inserted instead
+void online_hull_init(online_hull& h, const vector<point>& points, const vector<int>& ring)
+{
+	online_hull_clear(h);
+
+	if (ring.empty())
+	{
+		for (int i = 0; i < points.size(); i++)
+			online_hull_insert(h, points, i);
+	}
+	else
+	{
+		for (int i : ring)
+			online_hull_insert(h, points, i);
+	}
+
+	h.count = points.size();
+}
+
+//this method fills ring with the indices of the online hull vertices, in the same clockwise order as the other hulls
+//the ring is the top chain from the min point, then the bottom chain back from the max point, without the end points it shares with the top
+//like the other hulls, there is no ring until at least three points have been inserted
+void online_hull_ring(const online_hull& h, vector<int>& ring)
+{
+	vector<int>().swap(ring); //clear the ring vector before filling it
+
+	if (h.count < 3)
+		return;
+
+	for (const pair<const point, int>& v : h.top)
+		ring.push_back(v.second);
+
+	//when all the points are colinear, the bottom chain is just the two end points, so there is nothing more to add
+	for (auto it = next(h.bottom.rbegin()); it != h.bottom.rend() && next(it) != h.bottom.rend(); ++it)
+		ring.push_back(it->second);
+}
+
+//this method clears the streaming hull, so it holds no points
+void stream_hull_clear(stream_hull& h)
+{
+	vector<point>().swap(h.points);
+	vector<long long>().swap(h.index);
+	vector<point>().swap(h.hull);
+	h.count = 0;
+}
+
+//this method checks if p is strictly inside the convex polygon poly, given in counter clockwise order with no colinear corners
+//the polygon is split into a fan of triangles from its first corner, and a binary search finds the triangle p is in, which is O(log h)
+static bool strictly_inside(const vector<point>& poly, point p)
+{
+	int h = poly.size();
+	if (h < 3 || orient2d(poly[0], poly[1], p) <= 0 || orient2d(poly[0], poly[h - 1], p) >= 0)
+		return false;
+
+	//find the last corner k with p on or to the left of the line from the first corner to k
+	int lo = 1, hi = h - 1;
+	while (hi - lo > 1)
+	{
+		int mid = (lo + hi) / 2;
+		if (orient2d(poly[0], poly[mid], p) >= 0)
+			lo = mid;
+		else
+			hi = mid;
+	}
+
+	return orient2d(poly[lo], poly[lo + 1], p) > 0;
+}
+
+//this method cuts the candidates down to the ones a hull of the stream can still pick, once they are all on one line (or all the same point)
+//every later hull has the whole line on or inside it, so only its two ends can be vertices of a hull without colinear points,
+//and the first copy of each end is kept for the index order tie breaks, along with the first points with the smallest and largest x, which the quick hull starts from
+//other points are kept until there are three, as the hulls give a ring for three or more points on a line, and nothing for two
+static void stream_keep_ends(stream_hull& h)
+{
+	int ends[4] = { 0, 0, 0, 0 };
+	for (int i = 1; i < h.points.size(); i++)
+	{
+		point p = h.points[i];
+		if (point_less(p, h.points[ends[0]]))
+			ends[0] = i;
+		if (point_less(h.points[ends[1]], p))
+			ends[1] = i;
+		if (p.x < h.points[ends[2]].x)
+			ends[2] = i;
+		if (p.x > h.points[ends[3]].x)
+			ends[3] = i;
+	}
+
+	//keep the ends in stream order, along with the first other points until there are three
+	sort(ends, ends + 4);
+	int distinct = unique(ends, ends + 4) - ends;
+	int others = 3 - distinct, kept = 0;
+	for (int i = 0; i < h.points.size(); i++)
+	{
+		bool end = binary_search(ends, ends + distinct, i);
+		if (end || others > 0)
+		{
+			if (!end)
+				others--;
+			h.points[kept] = h.points[i];
+			h.index[kept] = h.index[i];
+			kept++;
+		}
+	}
+
+	h.points.resize(kept);
+	h.index.resize(kept);
+}
+
+//this method adds the next n points of the stream to the streaming hull
+//the points strictly inside the octagon of the running hull are thrown away in O(1) each, then the ones strictly inside the running hull itself in O(log h) each
+//when any points get past both, the running hull is built again from its own corners and the new candidates (without colinear points),
+//and only the candidates that are not strictly inside it are kept, so the points on its edges and any copies of its vertices stay,
+//as the in memory hulls can pick those when breaking ties
+//while the candidates are all on one line there is no running hull, and they are cut down to the ends of the line with stream_keep_ends
+//the candidates stay in stream order, so index order ties are broken the same way as on the whole stream
+void stream_hull_add(stream_hull& h, const point* chunk, int n)
+{
+	STATS_SPAN("stream_hull_add");
+	//throw away the points strictly inside the octagon of the running hull or the hull itself, which can't be on the hull
+	point oct[8];
+	int corners = 0;
+	if (!h.hull.empty())
+	{
+		point ext[8];
+		extreme_octagon(h.hull, 0, h.hull.size(), ext);
+		corners = filter_corners(ext, 1, oct);
+	}
+
+	int first = h.points.size();
+	for (int i = 0; i < n; i++)
+	{
+		if (!inside_octagon(oct, corners, chunk[i]) && !strictly_inside(h.hull, chunk[i]))
+		{
+			h.points.push_back(chunk[i]);
+			h.index.push_back(h.count + i);
+		}
+	}
+	h.count += n;
+
+	if (h.points.size() == first)
+		return;
+
+	//build the hull of the corners and the new candidates (or of all the candidates, when there are no corners), and turn it counter clockwise
+	vector<point> around(h.hull.empty() ? h.points.begin() : h.points.begin() + first, h.points.end());
+	around.insert(around.end(), h.hull.begin(), h.hull.end());
+	vector<int> ring;
+	compute_hull(around, HULL_MONOTONE, 1, ring);
+
+	h.hull.clear();
+	for (int k = ring.size() - 1; k >= 0; k--)
+		h.hull.push_back(around[ring[k]]);
+
+	if (h.hull.size() < 3)
+	{
+		h.hull.clear();
+		stream_keep_ends(h);
+		return;
+	}
+
+	//keep only the candidates that are not strictly inside the hull
+	int kept = 0;
+	for (int i = 0; i < h.points.size(); i++)
+	{
+		if (!strictly_inside(h.hull, h.points[i]))
+		{
+			h.points[kept] = h.points[i];
+			h.index[kept] = h.index[i];
+			kept++;
+		}
+	}
+
+	h.points.resize(kept);
+	h.index.resize(kept);
+}
+
+//this method creates the hull of every point given so far with the given algorithm (HULL_QUICK or HULL_MONOTONE),
+//filling ring with the indices of the hull vertices in h.points, in the same clockwise order as compute_hull
+void stream_hull_ring(const stream_hull& h, int method, vector<int>& ring)
+{
+	vector<int>().swap(ring); //clear the ring vector before filling it
+
+	vector<int> idx(h.points.size());
+	for (int i = 0; i < idx.size(); i++)
+		idx[i] = i;
+
+	index_hull(h.points, idx, method, ring);
+}
@@ -0,0 +1,164 @@
+/* These are the convex hull algorithms, shared by the 2D hull peeler and the batch tool.
+* None of them touch any global state, so they can be called on any points, from any thread.
+* Every hull is given as a ring of indices into the points it was built from, going clockwise from the point with the minimum x (and the minimum y of those).
+* The hulls and the peel can also run on a point view (see store.h), giving the same indices as on the points the view was taken from.
+*/
+
+#pragma once
+
+#include <vector>
+#include <map>
+#include "geometry.h"
+#include "store.h"
+#include "job.h"
+
+//enums for the convex hull algorithms
+enum {
+	HULL_QUICK, HULL_MONOTONE
+};
+
+//enums for the interior point filter a hull can run first (the Akl-Toussaint filter), which finds the extreme points in 4 directions (the largest and smallest x and y)
+//or 8 directions (x, y, x + y and y - x), and throws away the points strictly inside the polygon they make
+enum {
+	HULL_FILTER_NONE, HULL_FILTER_QUAD, HULL_FILTER_OCTAGON
+};
+
+//the smallest number of points worth giving to each thread of a parallel hull
+const int HULL_CHUNK_MIN = 50000;
+
+//the quick hull task structure, a range of the quick hull working set still to be hulled
+//the range holds the points strictly left of the line from point i1 to point i2, and its hull adds the vertices from i1 up to (not including) i2 to the ring
+typedef struct
+{
+	int lo, hi; //the range [lo, hi) of the working set
+	int i1, i2; //the indices of the points at the ends of the line
+	int depth; //the number of splits from the first line to this range
+} hull_task;
+
+//the hull scratch structure, the temporary arrays of the hulls and the peel, which can be kept from one run to the next
+//a hull or peel given a scratch resizes the arrays left in it by the last run instead of allocating its own,
+//so repeated runs on similar numbers of points (like the clusters of a cluster peel) don't go back to the heap at all
+//a scratch can only be used by one run at a time
+typedef struct
+{
+	std::vector<int> idx; //the indices of the points, reordered by the quick hull, sorted by the monotone chain and the peel
+	std::vector<int> xs, ys; //the 32-bit coordinates of the quick hull working set
+	std::vector<unsigned short> cx, cy; //the 16-bit offsets of the quick hull working set, for a compact view
+	std::vector<int> upper, lower; //the two halves of each layer of the peel, upper is also the chain of the monotone chain
+	std::vector<char> peeled; //which points the peel has put on a layer
+	std::vector<int> upperTree, lowerTree; //the bridges of the peel trees, which keep the two halves of the hull of the points the peel has left
+	std::vector<int> gone; //the sorted positions of the points of the last layer, which the peel takes out of the trees
+	std::vector<hull_task> tasks; //the quick hull ranges still to be hulled
+} hull_scratch;
+
+//this method creates a convex hull using the quick hull algorithm, using only the points whose indices are in idx (which is reordered)
+void quick_convex_hull(const std::vector<point>& points, std::vector<int>& idx, std::vector<int>& ring);
+
+//this method creates a convex hull using the monotone chain algorithm, using only the points whose indices are in order (which is sorted)
+void monotone_convex_hull(const std::vector<point>& points, std::vector<int>& order, std::vector<int>& ring);
+
+//this method creates a convex hull the same way as the first layer of the peel, keeping the colinear points along its edges as hull vertices,
+//using only the points whose indices are in order (which is sorted)
+//when all the points are colinear, the ring holds every one of them, in order along the line
+void boundary_convex_hull(const std::vector<point>& points, std::vector<int>& order, std::vector<int>& ring);
+
+//this method creates a convex hull of the points whose indices are in idx, using the given algorithm (HULL_QUICK or HULL_MONOTONE)
+void index_hull(const std::vector<point>& points, std::vector<int>& idx, int method, std::vector<int>& ring);
+
+//this method creates a convex hull of the points in the view whose indices are in idx, using the given algorithm (HULL_QUICK or HULL_MONOTONE)
+void index_hull(const point_view& v, std::vector<int>& idx, int method, std::vector<int>& ring);
+
+//this method creates a convex hull of the points on the given number of threads, merging the hulls of one chunk of points for each thread
+void parallel_convex_hull(const std::vector<point>& points, int method, int threads, std::vector<int>& ring);
+
+//this method creates a convex hull of the points, filling ring with the indices of the hull vertices, using up to the given number of threads
+void compute_hull(const std::vector<point>& points, int method, int threads, std::vector<int>& ring);
+
+//this method creates a convex hull of the points in the view, filling ring with the indices of the hull vertices, using up to the given number of threads
+void compute_hull(const point_view& v, int method, int threads, std::vector<int>& ring);
+
+//these methods create a convex hull the same way, keeping the temporary arrays in the scratch, which is reused from the last hull given it
+void compute_hull(const std::vector<point>& points, int method, int threads, std::vector<int>& ring, hull_scratch& scratch);
+void compute_hull(const point_view& v, int method, int threads, std::vector<int>& ring, hull_scratch& scratch);
+
+//these methods create a convex hull the same way, first throwing away the points strictly inside the polygon of the extreme points in the directions of the filter (one of the HULL_FILTER enums)
+//those points can never be hull vertices, so the ring is the same as without the filter, but on uniform points the hull only has to scan the few percent of points left
+//the filter is a single O(n) pass, and on a parallel hull each thread filters its own chunk
+//returns the number of points the filter threw away
+int filtered_hull(const std::vector<point>& points, int method, int threads, int filter, std::vector<int>& ring, hull_scratch& scratch);
+int filtered_hull(const point_view& v, int method, int threads, int filter, std::vector<int>& ring, hull_scratch& scratch);
+
+//this method peels all the hull layers of the points, filling layers with the indices of the points in each layer
+//equal points are only put on a layer once, as the copy with the smallest index
+void peel_layers(const std::vector<point>& points, std::vector<std::vector<int>>& layers);
+
+//this method peels all the hull layers of the points in the view, filling layers with the indices of the points in each layer
+void peel_layers(const point_view& v, std::vector<std::vector<int>>& layers);
+
+//this method peels all the hull layers of the points the same way, keeping the temporary arrays in the scratch and counting one step of the progress for each layer peeled
+//returns false, with no layers, if the progress was cancelled before the last layer
+bool peel_layers(const std::vector<point>& points, std::vector<std::vector<int>>& layers, hull_scratch& scratch, job_progress& progress);
+
+//this method peels the clusters of the points (the groups of indices from make_clusters) using up to the given number of threads,
+//filling layers with the hull layers of each cluster in the same order as the groups, as indices into the points
+void peel_clusters(const std::vector<point>& points, const std::vector<std::vector<int>>& groups, int threads, std::vector<std::vector<std::vector<int>>>& layers);
+
+//this method peels the clusters the same way, counting one step of the progress for each layer peeled in any cluster
+//returns false, with no layers, if the progress was cancelled before the last cluster was peeled
+bool peel_clusters(const std::vector<point>& points, const std::vector<std::vector<int>>& groups, int threads, std::vector<std::vector<std::vector<int>>>& layers, job_progress& progress);
+
+//the ordering of points by x then y, for keeping points in a map
+struct point_order
+{
+	bool operator()(point p1, point p2) const { return point_less(p1, p2); }
+};
+
+//the online hull structure, a convex hull kept current as points are added one at a time
+//the top and bottom chains of the hull are kept in balanced trees ordered by x then y, mapping each vertex to its index in the points
+//this is the same pair of chains the monotone chain builds, so both hulls give the same ring for the same points
+//of equal points only the first one inserted is kept, which is the one with the smallest index when the points are inserted in order, the same copy the monotone chain keeps
+typedef struct
+{
+	std::map<point, int, point_order> top; //the top chain, from the min point to the max point
+	std::map<point, int, point_order> bottom; //the bottom chain, from the min point to the max point
+	int count; //the number of points inserted so far, including the ones inside the hull
+} online_hull;
+
+//this method clears the online hull, so it holds no points
+void online_hull_clear(online_hull& h);
+
+//this method inserts point i of the points into the online hull, returning true if it became a hull vertex
+//a point inside the hull (or on its edges) is rejected in O(log h), and a new vertex costs O(log h) amortized, where h is the number of hull vertices
+bool online_hull_insert(online_hull& h, const std::vector<point>& points, int i);
+
+//this method starts the online hull from a hull already built from the points, so only the ring vertices need to be inserted
+void online_hull_init(online_hull& h, const std::vector<point>& points, const std::vector<int>& ring);
+
+//this method fills ring with the indices of the online hull vertices, in the same clockwise order as the other hulls
+void online_hull_ring(const online_hull& h, std::vector<int>& ring);
+
+//the streaming hull structure, a convex hull of a stream of points too large to hold at once, given to it a chunk at a time
+//only the candidates are kept: every point given so far that is not strictly inside the hull of the points given so far,
+//or while those are all on one line, just the ends of the line and the few copies the hulls can pick from it
+//the hull algorithms only ever pick points on the boundary of the hull, so the hull of the candidates is the same as the hull of the whole stream
+typedef struct
+{
+	std::vector<point> points; //the candidates, in the order they were given
+	std::vector<long long> index; //the position in the stream of each candidate
+	std::vector<point> hull; //the corners of the hull of the candidates in counter clockwise order, empty while they are all on one line
+	long long count; //the number of points given so far
+} stream_hull;
+
+//this method clears the streaming hull, so it holds no points
+void stream_hull_clear(stream_hull& h);
+
+//this method adds the next n points of the stream to the streaming hull
+//the points are first checked against the octagon of the running hull (the Akl-Toussaint filter), which throws away most interior points in O(1) each,
+//then against the running hull itself, and only when some get past both is the hull built again, from its corners and the new candidates
+//while all the candidates are on one line, only the ends of the line (and the copies the hulls can pick when breaking ties) are kept
+void stream_hull_add(stream_hull& h, const point* chunk, int n);
+
+//this method creates the hull of every point given so far with the given algorithm (HULL_QUICK or HULL_MONOTONE),
+//filling ring with the indices of the hull vertices in h.points, in the same clockwise order as compute_hull
+//the positions in the stream of the vertices are the matching entries of h.index, and give the same ring as compute_hull on the whole stream
+void stream_hull_ring(const stream_hull& h, int method, std::vector<int>& ring);
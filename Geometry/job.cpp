@@ -0,0 +1,50 @@
+/* This is the implementation of the background job.
+* See job.h for how a job shares its progress.
+*/
+
+#include "job.h"
+using namespace std;
+
+//this method starts running work on a new worker thread, passing it the progress of the job
+void job_start(job& j, const function<void(job_progress&)>& work)
+{
+	j.progress.done = 0;
+	j.progress.cancel = false;
+	j.finished = false;
+
+	//the work is copied into the thread, so it doesn't matter what happens to the one given once this returns
+	j.worker = thread([&j, work]()
+	{
+		work(j.progress);
+		j.finished.store(true, memory_order_release);
+	});
+}
+
+//this method returns true if the job has been started and not collected yet
+bool job_running(const job& j)
+{
+	return j.worker.joinable();
+}
+
+//this method collects the job if its work has returned, waiting for the worker thread
+bool job_collect(job& j)
+{
+	if (!j.worker.joinable() || !j.finished.load(memory_order_acquire))
+		return false;
+
+	j.worker.join();
+	return true;
+}
+
+//this method asks the work of the job to stop
+void job_cancel(job& j)
+{
+	j.progress.cancel = true;
+}
+
+//this method waits for the work of the job to return and collects it
+void job_wait(job& j)
+{
+	if (j.worker.joinable())
+		j.worker.join();
+}
@@ -0,0 +1,50 @@
+/* This is the background job, used by the 2D apps to run a long computation (like a hull peel or a triangulation) off the window thread.
+* The work runs on a worker thread, and shares only its progress and a cancel flag with the thread that started it, both atomic.
+* The window keeps drawing and polls the job, and picks up the results only once the work has returned, so it never sees them half done.
+* The algorithms that can report their progress (see peel_layers and delaunay) count their steps in it as they go, and stop early when it is cancelled.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <thread>
+
+//the job progress structure, shared between the work of a job and the thread watching it
+typedef struct
+{
+	std::atomic<long long> done; //the number of steps of the work done so far (layers peeled, triangles made and so on)
+	std::atomic<bool> cancel; //set to ask the work to stop early
+} job_progress;
+
+//this method counts steps more steps of work as done, returning false if the work has been asked to stop
+inline bool job_step(job_progress& p, long long steps)
+{
+	p.done.fetch_add(steps, std::memory_order_relaxed);
+	return !p.cancel.load(std::memory_order_relaxed);
+}
+
+//the job structure, work running on a worker thread
+typedef struct
+{
+	std::thread worker; //the thread running the work, not joinable when there is no job to collect
+	std::atomic<bool> finished; //set by the worker once the work has returned
+	job_progress progress; //the progress of the work, which it is given to update
+} job;
+
+//this method starts running work on a new worker thread, passing it the progress of the job
+//the job must not be running already, so a job has to be collected (or cancelled) before it is started again
+void job_start(job& j, const std::function<void(job_progress&)>& work);
+
+//this method returns true if the job has been started and not collected yet, even if its work has returned
+bool job_running(const job& j);
+
+//this method collects the job if its work has returned, waiting for the worker thread, so whatever the work made can be used
+//returns false if the work has not returned yet, or there is no job to collect
+bool job_collect(job& j);
+
+//this method asks the work of the job to stop, which it does at its next step, the job still has to be collected once it has
+void job_cancel(job& j);
+
+//this method waits for the work of the job to return and collects it, doing nothing if there is no job to collect
+void job_wait(job& j);
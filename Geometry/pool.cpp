@@ -0,0 +1,102 @@
+/* This is the implementation of the work stealing pool.
+* See pool.h for how the items are shared out.
+*/
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <algorithm>
+#include "pool.h"
+using namespace std;
+
+//the slice structure, the items a thread has left, [next, end), which any thread can change while holding the lock
+typedef struct
+{
+	mutex lock; //held while the ends of the slice are read or moved
+	int next, end; //the items left in the slice
+} pool_slice;
+
+//this method takes up to grain items off the front of the slice into [lo, hi), returning false if it is empty
+static bool take_items(pool_slice& s, int grain, int& lo, int& hi)
+{
+	lock_guard<mutex> guard(s.lock);
+	if (s.next == s.end)
+		return false;
+
+	lo = s.next;
+	hi = min(s.end, s.next + grain);
+	s.next = hi;
+	return true;
+}
+
+//this method steals the back half of another slice into the slice of thread w, which is empty, returning false if every other slice is empty too
+//the slices are tried in turn starting after w, so the thieves spread out over the slices rather than all going for the same one
+static bool steal_items(vector<pool_slice>& slices, int w)
+{
+	int threads = slices.size();
+	for (int k = 1; k < threads; k++)
+	{
+		pool_slice& victim = slices[(w + k) % threads];
+		int lo, hi;
+		{
+			lock_guard<mutex> guard(victim.lock);
+			int left = victim.end - victim.next;
+			if (left == 0)
+				continue;
+
+			hi = victim.end;
+			lo = victim.end - (left + 1) / 2;
+			victim.end = lo;
+		}
+
+		lock_guard<mutex> guard(slices[w].lock);
+		slices[w].next = lo;
+		slices[w].end = hi;
+		return true;
+	}
+
+	return false;
+}
+
+//this method runs work on the items [0, count) using up to the given number of threads
+void pool_run(int count, int threads, int grain, const function<void(int worker, int lo, int hi)>& work)
+{
+	grain = max(1, grain);
+	threads = max(1, min(threads, count / grain));
+
+	if (threads == 1)
+	{
+		for (int lo = 0; lo < count; lo += grain)
+			work(0, lo, min(count, lo + grain));
+		return;
+	}
+
+	//give each thread an equal slice to start from
+	vector<pool_slice> slices(threads);
+	for (int t = 0; t < threads; t++)
+	{
+		slices[t].next = (long long)count * t / threads;
+		slices[t].end = (long long)count * (t + 1) / threads;
+	}
+
+	vector<thread> workers;
+	for (int t = 0; t < threads; t++)
+	{
+		workers.push_back(thread([&, t]()
+		{
+			//work through the slice, then steal more, until every slice is empty
+			//a stolen slice can be stolen from again before its thief gets to it, so the thief just goes back to stealing
+			int lo, hi;
+			for (;;)
+			{
+				if (take_items(slices[t], grain, lo, hi))
+					work(t, lo, hi);
+				else if (!steal_items(slices, t))
+					break;
+			}
+		}));
+	}
+
+	for (thread& w : workers)
+		w.join();
+}
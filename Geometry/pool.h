@@ -0,0 +1,14 @@
+/* This is the work stealing pool, which shares out a range of items (like the point sets of a batch) between threads.
+* Each thread starts with an equal slice of the range and takes a few items at a time off the front of its slice.
+* A thread that runs out steals the back half of what is left of another slice, so the threads that get quick items help the ones that got slow ones,
+* and the threads only ever wait on each other for the moment it takes to move the ends of a slice.
+*/
+
+#pragma once
+
+#include <functional>
+
+//this method runs work on the items [0, count) using up to the given number of threads, waiting until every item is done
+//work is called with the number of the thread calling it, in [0, threads), and a range [lo, hi) of at most grain items, so it can keep its own state for each thread
+//every item is in exactly one range, and with a single thread (or fewer than two grains of items) everything is done on the calling thread
+void pool_run(int count, int threads, int grain, const std::function<void(int worker, int lo, int hi)>& work);
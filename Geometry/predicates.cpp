@@ -0,0 +1,141 @@
+/* This is the slow side of the geometric predicates, used when the 64-bit fast paths in predicates.h could overflow.
+* The exact fallback works in 256-bit two's complement integers made of eight 32-bit limbs, which is plenty for the
+* 135 bits the incircle determinant of 33-bit terms can need, and leaves out __int128 so it builds with any compiler.
+*/
+
+#include <cmath>
+#include "predicates.h"
+using namespace std;
+
+//the 256-bit integer structure, with limb 0 the lowest
+typedef struct
+{
+	unsigned int limb[8];
+} wide;
+
+//this method creates a wide integer from a 64-bit integer, filling the upper limbs with its sign
+static wide wide_from(long long v)
+{
+	wide w;
+	unsigned long long u = (unsigned long long)v;
+	unsigned int fill = v < 0 ? 0xFFFFFFFFu : 0;
+
+	w.limb[0] = (unsigned int)u;
+	w.limb[1] = (unsigned int)(u >> 32);
+	for (int i = 2; i < 8; i++)
+		w.limb[i] = fill;
+
+	return w;
+}
+
+//this method adds two wide integers, dropping any carry out of the top limb
+static wide wide_add(const wide& a, const wide& b)
+{
+	wide w;
+	unsigned long long carry = 0;
+
+	for (int i = 0; i < 8; i++)
+	{
+		carry += (unsigned long long)a.limb[i] + b.limb[i];
+		w.limb[i] = (unsigned int)carry;
+		carry >>= 32;
+	}
+
+	return w;
+}
+
+//this method subtracts b from a
+static wide wide_sub(const wide& a, const wide& b)
+{
+	//a - b = a + ~b + 1
+	wide nb;
+	for (int i = 0; i < 8; i++)
+		nb.limb[i] = ~b.limb[i];
+
+	return wide_add(wide_add(a, nb), wide_from(1));
+}
+
+//this method multiplies two wide integers, keeping the low 256 bits of the product
+//as the low bits of a two's complement product do not depend on the signs, the limbs are multiplied as if they were unsigned
+static wide wide_mul(const wide& a, const wide& b)
+{
+	wide w;
+	for (int i = 0; i < 8; i++)
+		w.limb[i] = 0;
+
+	for (int i = 0; i < 8; i++)
+	{
+		unsigned long long carry = 0;
+		for (int j = 0; i + j < 8; j++)
+		{
+			carry += (unsigned long long)a.limb[i] * b.limb[j] + w.limb[i + j];
+			w.limb[i + j] = (unsigned int)carry;
+			carry >>= 32;
+		}
+	}
+
+	return w;
+}
+
+//this method returns the sign of a wide integer
+static int wide_sign(const wide& w)
+{
+	if (w.limb[7] & 0x80000000u)
+		return -1;
+
+	for (int i = 0; i < 8; i++)
+		if (w.limb[i] != 0)
+			return 1;
+
+	return 0;
+}
+
+//this method returns the exact sign of a * d - b * c when the fast path in det2 cannot be used
+int det2_exact(long long a, long long b, long long c, long long d)
+{
+	return wide_sign(wide_sub(wide_mul(wide_from(a), wide_from(d)), wide_mul(wide_from(b), wide_from(c))));
+}
+
+//this method returns the sign of the incircle determinant when the fast path in incircle cannot be used
+//the terms are differences of int coordinates, so they fit into 33 bits and are exact as doubles
+//the determinant is first worked out in doubles, and the sign is trusted when it is larger than the error bound from Shewchuk's robust predicates
+//otherwise the determinant is worked out exactly with wide integers
+int incircle_filtered(long long adx, long long ady, long long bdx, long long bdy, long long cdx, long long cdy)
+{
+	double ax = (double)adx, ay = (double)ady;
+	double bx = (double)bdx, by = (double)bdy;
+	double cx = (double)cdx, cy = (double)cdy;
+
+	double bxcy = bx * cy, cxby = cx * by;
+	double cxay = cx * ay, axcy = ax * cy;
+	double axby = ax * by, bxay = bx * ay;
+	double alift = ax * ax + ay * ay;
+	double blift = bx * bx + by * by;
+	double clift = cx * cx + cy * cy;
+
+	double det = alift * (bxcy - cxby) + blift * (cxay - axcy) + clift * (axby - bxay);
+	double permanent = (fabs(bxcy) + fabs(cxby)) * alift + (fabs(cxay) + fabs(axcy)) * blift + (fabs(axby) + fabs(bxay)) * clift;
+
+	//the error bound is (10 + 96e)e times the permanent, where e is half the spacing of doubles around 1
+	const double epsilon = 1.1102230246251565e-16;
+	const double bound = (10.0 + 96.0 * epsilon) * epsilon * permanent;
+	if (det > bound)
+		return 1;
+	if (-det > bound)
+		return -1;
+
+	//the sign is too close to call, so work out the determinant exactly
+	wide wax = wide_from(adx), way = wide_from(ady);
+	wide wbx = wide_from(bdx), wby = wide_from(bdy);
+	wide wcx = wide_from(cdx), wcy = wide_from(cdy);
+
+	wide wa = wide_add(wide_mul(wax, wax), wide_mul(way, way));
+	wide wb = wide_add(wide_mul(wbx, wbx), wide_mul(wby, wby));
+	wide wc = wide_add(wide_mul(wcx, wcx), wide_mul(wcy, wcy));
+
+	wide wdet = wide_mul(wa, wide_sub(wide_mul(wbx, wcy), wide_mul(wcx, wby)));
+	wdet = wide_add(wdet, wide_mul(wb, wide_sub(wide_mul(wcx, way), wide_mul(wax, wcy))));
+	wdet = wide_add(wdet, wide_mul(wc, wide_sub(wide_mul(wax, wby), wide_mul(wbx, way))));
+
+	return wide_sign(wdet);
+}
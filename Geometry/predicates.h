@@ -0,0 +1,89 @@
+/* These are the geometric predicates used by both the convex hull and the triangulation.
+* Each one returns the exact sign of a determinant of int coordinates, so the answer is right no matter how large the coordinates get.
+* The common case (window sized coordinates) is worked out with plain 64-bit integer math, which is exact when the terms are small enough.
+* Larger coordinates go to predicates.cpp, where incircle first tries a floating point filter that only fails when the sign is too close to call.
+* Only when neither fast path can be trusted is the exact fallback used, which works in 256-bit integers.
+*/
+
+#pragma once
+
+#include "geometry.h"
+#include "stats.h"
+
+//this method returns the exact sign of a * d - b * c when the fast path in det2 cannot be used
+int det2_exact(long long a, long long b, long long c, long long d);
+
+//this method returns the sign of the incircle determinant when the fast path in incircle cannot be used
+//it tries a floating point filter first, and only works out the exact determinant when the filter cannot tell the sign
+int incircle_filtered(long long adx, long long ady, long long bdx, long long bdy, long long cdx, long long cdy);
+
+//this method returns the sign of a * d - b * c, where each term is the difference of two int coordinates
+//when every term is below 2^31 both products are below 2^62, so the 64-bit result cannot overflow
+inline int det2(long long a, long long b, long long c, long long d)
+{
+	const long long limit = 1LL << 31;
+	if (a > -limit && a < limit && b > -limit && b < limit && c > -limit && c < limit && d > -limit && d < limit)
+	{
+		long long det = a * d - b * c;
+		return (det > 0) - (det < 0);
+	}
+
+	return det2_exact(a, b, c, d);
+}
+
+//this method returns the orientation of point p3 relative to the line p1p2
+//returns 1 when p3 is to the left of the line, -1 when it is to the right and 0 when the three points are colinear
+inline int orient2d(point p1, point p2, point p3)
+{
+	STATS_ADD(STAT_ORIENT, 1);
+	return det2((long long)p2.x - p1.x, (long long)p2.y - p1.y, (long long)p3.x - p1.x, (long long)p3.y - p1.y);
+}
+
+//this method compares the distances of points p3 and p4 from the line p1p2, measured to the left of the line
+//returns 1 when p3 is farther, -1 when p4 is farther and 0 when they are the same distance
+inline int compare_dist(point p1, point p2, point p3, point p4)
+{
+	return det2((long long)p2.x - p1.x, (long long)p2.y - p1.y, (long long)p3.x - p4.x, (long long)p3.y - p4.y);
+}
+
+//this method compares the length of p1p2 to the length of p3p4
+//returns 1 when p1p2 is longer, -1 when p3p4 is longer and 0 when they are the same length
+inline int compare_length(point p1, point p2, point p3, point p4)
+{
+	long long ax = (long long)p2.x - p1.x, ay = (long long)p2.y - p1.y;
+	long long bx = (long long)p4.x - p3.x, by = (long long)p4.y - p3.y;
+	const long long limit = 1LL << 31;
+	if (ax > -limit && ax < limit && ay > -limit && ay < limit && bx > -limit && bx < limit && by > -limit && by < limit)
+	{
+		long long l1 = ax * ax + ay * ay, l2 = bx * bx + by * by;
+		return (l1 > l2) - (l1 < l2);
+	}
+
+	//ax^2 - bx^2 + ay^2 - by^2 = (ax - bx)(ax + bx) + (ay - by)(ay + by), which is a * d - b * c with 34-bit terms
+	return det2_exact(ax - bx, -(ay - by), ay + by, ax + bx);
+}
+
+//this method checks if point p4 is inside the circle through the counter clockwise triangle p1p2p3
+//returns 1 when it is inside, -1 when it is outside and 0 when all four points are on the same circle
+inline int incircle(point p1, point p2, point p3, point p4)
+{
+	STATS_ADD(STAT_INCIRCLE, 1);
+
+	//find the positions of the triangle points relative to p4
+	long long adx = (long long)p1.x - p4.x, ady = (long long)p1.y - p4.y;
+	long long bdx = (long long)p2.x - p4.x, bdy = (long long)p2.y - p4.y;
+	long long cdx = (long long)p3.x - p4.x, cdy = (long long)p3.y - p4.y;
+
+	//when every term is below 2^14, each of the three products is below 2^58, so the 64-bit sum cannot overflow
+	const long long limit = 1LL << 14;
+	if (adx > -limit && adx < limit && ady > -limit && ady < limit && bdx > -limit && bdx < limit
+		&& bdy > -limit && bdy < limit && cdx > -limit && cdx < limit && cdy > -limit && cdy < limit)
+	{
+		long long det = (adx * adx + ady * ady) * (bdx * cdy - cdx * bdy)
+			+ (bdx * bdx + bdy * bdy) * (cdx * ady - adx * cdy)
+			+ (cdx * cdx + cdy * cdy) * (adx * bdy - bdx * ady);
+		return (det > 0) - (det < 0);
+	}
+
+	return incircle_filtered(adx, ady, bdx, bdy, cdx, cdy);
+}
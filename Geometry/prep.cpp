@@ -0,0 +1,112 @@
+/* This is the implementation of the preprocessing of point sets.
+* See prep.h for what the prepared points hold.
+*/
+
+#include <algorithm>
+#include "prep.h"
+#include "hull.h"
+#include "predicates.h"
+#include "stats.h"
+using namespace std;
+
+//this method returns the key of a point for the key set, its x in the high 32 bits and its y in the low 32 bits
+static long long point_key(point p)
+{
+	return (long long)((unsigned long long)(unsigned int)p.x << 32 | (unsigned int)p.y);
+}
+
+//this method prepares the input points, sorting them and removing the duplicates in O(n log n), then flagging the colinear runs in O(n)
+//the indices are sorted with equal points in index order, so the first copy of each point is the one that is kept
+void prep_points(const vector<point>& input, prepared_points& p)
+{
+	STATS_SPAN("prep_points");
+	p.points.clear();
+	p.source.clear();
+	p.remap.resize(input.size());
+	p.duplicates = 0;
+	p.runs = 0;
+
+	vector<int> order(input.size());
+	for (int i = 0; i < order.size(); i++)
+		order[i] = i;
+	sort(order.begin(), order.end(), [&](int i, int j) { return point_less(input[i], input[j]) || (!point_less(input[j], input[i]) && i < j); });
+
+	//keep the first copy of each point, and send every copy to it
+	for (int i : order)
+	{
+		point q = input[i];
+		if (!p.points.empty() && p.points.back().x == q.x && p.points.back().y == q.y)
+			p.duplicates++;
+		else
+		{
+			p.points.push_back(q);
+			p.source.push_back(i);
+		}
+
+		p.remap[i] = p.points.size() - 1;
+	}
+
+	//flag each point colinear with the points either side of it, a new run starting at each flagged point after one that isn't
+	//two flagged points next to each other share two points, so they are on the same line and in the same run
+	p.colinear.assign(p.points.size(), false);
+	for (int i = 1; i + 1 < p.points.size(); i++)
+	{
+		if (orient2d(p.points[i - 1], p.points[i], p.points[i + 1]) == 0)
+		{
+			p.colinear[i] = true;
+			if (!p.colinear[i - 1])
+				p.runs++;
+		}
+	}
+}
+
+//this method creates the convex hull of the prepared points with the monotone chain, filling ring with the indices into the input of the hull vertices
+void prep_hull(const prepared_points& p, int colinear, vector<int>& ring)
+{
+	vector<int>().swap(ring); //clear the ring vector before filling it
+
+	//a flagged point can't be a corner, so only the others are given to the hull when the colinear points are dropped,
+	//unless that leaves too few for a hull, when every point is on one line and the hull is the two ends of it
+	vector<int> order;
+	for (int i = 0; i < p.points.size(); i++)
+		if (colinear == COLINEAR_KEEP || !p.colinear[i])
+			order.push_back(i);
+	if (order.size() < 3)
+	{
+		order.resize(p.points.size());
+		for (int i = 0; i < order.size(); i++)
+			order[i] = i;
+	}
+
+	if (colinear == COLINEAR_KEEP)
+		boundary_convex_hull(p.points, order, ring);
+	else
+		monotone_convex_hull(p.points, order, ring);
+
+	//turn the indices into the distinct points back into indices into the input
+	for (int& i : ring)
+		i = p.source[i];
+}
+
+//this method clears the key set, so it holds no points
+void keys_clear(point_keys& k)
+{
+	k.keys.clear();
+	k.count = 0;
+}
+
+//this method adds the keys of the points added to the end of the vector since the key set was last synced with it
+void keys_sync(point_keys& k, const vector<point>& points)
+{
+	if (k.count > points.size())
+		keys_clear(k);
+
+	for (; k.count < points.size(); k.count++)
+		k.keys.insert(point_key(points[k.count]));
+}
+
+//this method checks if the key set holds the point
+bool keys_has(const point_keys& k, point p)
+{
+	return k.keys.count(point_key(p)) > 0;
+}
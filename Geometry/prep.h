@@ -0,0 +1,57 @@
+/* This is the preprocessing of point sets, for input that can hold duplicates and long colinear runs, like point files or a lattice.
+* Preparing the points sorts them once, removing the duplicates and flagging the colinear runs, so the hulls built from them
+* don't have to break ties between copies of a point and can be told to keep or drop the colinear points along their edges.
+* It also has the point key set, a hash set for rejecting duplicates in O(1) as points are added one at a time (like mouse points).
+*/
+
+#pragma once
+
+#include <vector>
+#include <unordered_set>
+#include "geometry.h"
+
+//enums for the colinear points along the edges of a hull, which are either kept as hull vertices or dropped so every vertex is a corner
+enum {
+	COLINEAR_KEEP, COLINEAR_DROP
+};
+
+//the prepared points structure, the distinct points of an input, sorted by x then y, with what the preprocessing found out about them
+//a colinear run is three or more points in a row in sorted order on one line, and its points other than the two at its ends are flagged,
+//as each of those is strictly between two other points, so it can never be a corner of a hull
+typedef struct
+{
+	std::vector<point> points; //the distinct points, sorted by x then y
+	std::vector<int> source; //the index in the input of the first copy of each distinct point
+	std::vector<int> remap; //the index in points of each input point
+	std::vector<char> colinear; //true for each point strictly inside a colinear run
+	int duplicates; //the number of input points that were copies of an earlier point
+	int runs; //the number of colinear runs
+} prepared_points;
+
+//this method prepares the input points, sorting them and removing the duplicates in O(n log n), then flagging the colinear runs in O(n)
+void prep_points(const std::vector<point>& input, prepared_points& p);
+
+//this method creates the convex hull of the prepared points with the monotone chain, filling ring with the indices into the input of the hull vertices
+//with COLINEAR_KEEP the points along the edges are hull vertices, the same as the first layer of the peel,
+//and with COLINEAR_DROP only the corners are, skipping the flagged points before the hull is built
+//the points are already sorted, so the hull is O(n), and it is a hull of the distinct points, so there is none with fewer than three of them
+void prep_hull(const prepared_points& p, int colinear, std::vector<int>& ring);
+
+//the point key set structure, a hash set of the points of a vector, for rejecting duplicates in O(1) as points are added to it
+//it holds the keys of the first count points of the vector, and takes in the points added to the end of the vector since it was last synced,
+//so it only has to be cleared when the vector is emptied or replaced
+typedef struct
+{
+	std::unordered_set<long long> keys; //the key of each point, its x in the high 32 bits and its y in the low 32 bits
+	int count; //the number of points of the vector that have keys
+} point_keys;
+
+//this method clears the key set, so it holds no points
+void keys_clear(point_keys& k);
+
+//this method adds the keys of the points added to the end of the vector since the key set was last synced with it, in O(1) each
+//a vector shorter than the points the set holds has been replaced, so the keys are built again from all of it
+void keys_sync(point_keys& k, const std::vector<point>& points);
+
+//this method checks if the key set holds the point
+bool keys_has(const point_keys& k, point p);
@@ -0,0 +1,109 @@
+/* This is the implementation of the point sampler and its random number generator.
+* See sample.h for how the points are drawn.
+*/
+
+#include "sample.h"
+using namespace std;
+
+//this method seeds the random number generator
+void rng_seed(rng& r, unsigned long long seed)
+{
+	r.state = seed;
+}
+
+//this method returns the next random 64-bit number
+//this is splitmix64, which gives well mixed numbers from any seed, including 0
+unsigned long long rng_next(rng& r)
+{
+	unsigned long long z = (r.state += 0x9E3779B97F4A7C15ULL);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+//this method mixes one half of the Feistel network with a round key, giving the value xored into the other half
+static unsigned long long feistel_round(unsigned long long half, unsigned long long key)
+{
+	unsigned long long z = (half ^ key) * 0x9E3779B97F4A7C15ULL;
+	z ^= z >> 29;
+	z *= 0xBF58476D1CE4E5B9ULL;
+	return z ^ (z >> 32);
+}
+
+//this method maps index i in [0, size) to its place in the random permutation of the rectangle
+//the Feistel network is a permutation of [0, 2^(2 * halfBits)), and any result past the end of the rectangle is sent through it again
+//as the network covers less than four times the rectangle, this takes fewer than four rounds through on average
+static unsigned long long permute(const sampler& s, unsigned long long i)
+{
+	unsigned long long mask = (1ULL << s.halfBits) - 1;
+
+	do
+	{
+		unsigned long long left = i >> s.halfBits, right = i & mask;
+		for (int k = 0; k < 4; k++)
+		{
+			unsigned long long t = left ^ (feistel_round(right, s.keys[k]) & mask);
+			left = right;
+			right = t;
+		}
+		i = (left << s.halfBits) | right;
+	} while (i >= s.size);
+
+	return i;
+}
+
+//this method sets up the sampler to draw points from x in [minX, minX + cols) and y in [minY, minY + rows), in the order given by the seed
+void sampler_init(sampler& s, int minX, int minY, int cols, int rows, unsigned long long seed)
+{
+	s.minX = minX;
+	s.minY = minY;
+	s.cols = cols > 0 ? cols : 0;
+	s.rows = rows > 0 ? rows : 0;
+	s.size = (unsigned long long)s.cols * s.rows;
+	s.next = 0;
+
+	//find the smallest half size that covers the rectangle, keeping at least one bit in each half
+	s.halfBits = 1;
+	while (s.halfBits < 31 && (1ULL << (2 * s.halfBits)) < s.size)
+		s.halfBits++;
+
+	rng r;
+	rng_seed(r, seed);
+	for (int k = 0; k < 4; k++)
+		s.keys[k] = rng_next(r);
+}
+
+//this method returns the number of points the sampler can still draw before every coordinate has been used
+unsigned long long sampler_remaining(const sampler& s)
+{
+	return s.size - s.next;
+}
+
+//this method draws the next point, which is different from every point drawn before it
+//returns false when every coordinate has already been drawn
+bool sampler_next(sampler& s, point& p)
+{
+	if (s.next >= s.size)
+		return false;
+
+	unsigned long long i = permute(s, s.next++);
+	p.x = s.minX + (int)(i % s.cols);
+	p.y = s.minY + (int)(i / s.cols);
+
+	return true;
+}
+
+//this method draws up to n more points, adding them to the end of points, and returns how many were added
+int sampler_take(sampler& s, int n, vector<point>& points)
+{
+	int added = 0;
+	point p;
+
+	while (added < n && sampler_next(s, p))
+	{
+		points.push_back(p);
+		added++;
+	}
+
+	return added;
+}
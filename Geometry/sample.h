@@ -0,0 +1,47 @@
+/* This is the point sampler, used to draw random sets of distinct points from a rectangle of integer coordinates.
+* It never builds the list of every coordinate: the kth point is found by running k through a random permutation of the rectangle.
+* The permutation is a Feistel network over the smallest even number of bits that covers the rectangle, cycle walked back into it,
+* so the kth point costs O(1) time and the sampler only needs its keys, no matter how large the rectangle is.
+* Everything comes from a seedable random number generator, so the same seed gives the same points every run.
+*/
+
+#pragma once
+
+#include <vector>
+#include "geometry.h"
+
+//the random number generator structure (splitmix64)
+typedef struct
+{
+	unsigned long long state; //the current state, moved on by every number drawn
+} rng;
+
+//the point sampler structure
+typedef struct
+{
+	int minX, minY; //the bottom left corner of the rectangle
+	int cols, rows; //the width and height of the rectangle
+	unsigned long long size; //the number of coordinates in the rectangle, cols * rows
+	int halfBits; //the number of bits in each half of the Feistel network
+	unsigned long long keys[4]; //the key for each round of the Feistel network
+	unsigned long long next; //the index of the next point to draw
+} sampler;
+
+//this method seeds the random number generator
+void rng_seed(rng& r, unsigned long long seed);
+
+//this method returns the next random 64-bit number
+unsigned long long rng_next(rng& r);
+
+//this method sets up the sampler to draw points from x in [minX, minX + cols) and y in [minY, minY + rows), in the order given by the seed
+void sampler_init(sampler& s, int minX, int minY, int cols, int rows, unsigned long long seed);
+
+//this method returns the number of points the sampler can still draw before every coordinate has been used
+unsigned long long sampler_remaining(const sampler& s);
+
+//this method draws the next point, which is different from every point drawn before it
+//returns false when every coordinate has already been drawn
+bool sampler_next(sampler& s, point& p);
+
+//this method draws up to n more points, adding them to the end of points, and returns how many were added
+int sampler_take(sampler& s, int n, std::vector<point>& points);
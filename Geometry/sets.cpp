@@ -0,0 +1,183 @@
+/* This is the implementation of the batched hull and triangulation.
+* See sets.h for how the sets and their results are packed.
+*/
+
+#include <algorithm>
+#include "sets.h"
+#include "hull.h"
+#include "triangulation.h"
+#include "pool.h"
+#include "stats.h"
+using namespace std;
+
+//the set worker structure, what each thread keeps from one set to the next
+typedef struct
+{
+	vector<point> points; //the points of the set being worked on
+	vector<int> ring; //the hull of the set being worked on
+	hull_scratch scratch; //the temporary arrays of the hulls
+	halfedge_mesh mesh; //the triangulation of the set being worked on
+	vector<int> order; //the positions of the points of the set, sorted by x then y
+	vector<int> first; //the first position in the set of each vertex of the triangulation
+	vector<int> out; //the results of every set the thread has done, one after the other
+} set_worker;
+
+//the set result structure, where the result of a set was left
+typedef struct
+{
+	int worker; //the thread that did the set
+	int at; //where its result starts in the output of that thread
+	int size; //the number of indices in its result
+} set_result;
+
+//this method clears the point sets, so there are none
+void sets_clear(point_sets& s)
+{
+	vector<int>().swap(s.start);
+	vector<point>().swap(s.points);
+}
+
+//this method adds a set of n points to the end of the point sets
+void sets_add(point_sets& s, const point* points, int n)
+{
+	if (s.start.empty())
+		s.start.push_back(0);
+
+	s.points.insert(s.points.end(), points, points + n);
+	s.start.push_back(s.points.size());
+}
+
+//this method returns the number of sets
+int sets_count(const point_sets& s)
+{
+	return s.start.empty() ? 0 : s.start.size() - 1;
+}
+
+//this method checks that the starts of the sets go up from 0 to the number of points
+bool sets_check(const point_sets& s)
+{
+	if (s.start.empty())
+		return s.points.empty();
+
+	if (s.start[0] != 0 || s.start.back() != s.points.size())
+		return false;
+
+	for (int i = 1; i < s.start.size(); i++)
+		if (s.start[i] < s.start[i - 1])
+			return false;
+
+	return true;
+}
+
+//this method copies set s into the points of the worker
+static void load_set(const point_sets& sets, int s, set_worker& w)
+{
+	w.points.assign(sets.points.begin() + sets.start[s], sets.points.begin() + sets.start[s + 1]);
+}
+
+//this method adds the result of set s, the indices in [first, last), to the output of thread t
+template <typename It>
+static void keep_result(vector<set_worker>& workers, int t, int s, It first, It last, vector<set_result>& results)
+{
+	vector<int>& out = workers[t].out;
+	results[s] = set_result{ t, (int)out.size(), (int)(last - first) };
+	out.insert(out.end(), first, last);
+}
+
+//this method packs the results of every set, left in the outputs of the threads that did them, into lists in set order
+static void pack_results(const vector<set_worker>& workers, const vector<set_result>& results, index_sets& lists)
+{
+	int n = results.size();
+	lists.start.assign(n + 1, 0);
+	for (int s = 0; s < n; s++)
+		lists.start[s + 1] = lists.start[s] + results[s].size;
+
+	lists.index.resize(lists.start[n]);
+	for (int s = 0; s < n; s++)
+	{
+		const set_result& r = results[s];
+		const vector<int>& out = workers[r.worker].out;
+		copy(out.begin() + r.at, out.begin() + r.at + r.size, lists.index.begin() + lists.start[s]);
+	}
+}
+
+//this method creates the convex hull of every set with the given algorithm, using up to the given number of threads
+//each set is copied into the points of its thread and hulled with compute_hull on a single thread, reusing the scratch of the thread
+bool sets_hull(const point_sets& sets, int method, int threads, index_sets& hulls)
+{
+	STATS_SPAN("sets_hull");
+	vector<int>().swap(hulls.start);
+	vector<int>().swap(hulls.index);
+	if (!sets_check(sets))
+		return false;
+
+	int n = sets_count(sets);
+	threads = max(1, threads);
+	vector<set_worker> workers(threads);
+	vector<set_result> results(n);
+
+	pool_run(n, threads, SETS_GRAIN, [&](int t, int lo, int hi)
+	{
+		set_worker& w = workers[t];
+		for (int s = lo; s < hi; s++)
+		{
+			load_set(sets, s, w);
+			w.ring.clear();
+			compute_hull(w.points, method, 1, w.ring, w.scratch);
+			keep_result(workers, t, s, w.ring.begin(), w.ring.end(), results);
+		}
+	});
+
+	pack_results(workers, results, hulls);
+	return true;
+}
+
+//this method creates the delaunay triangulation of every set, using up to the given number of threads
+//each set is triangulated with delaunay into the mesh of its thread, whose vertices are the distinct points of the set sorted by x then y
+//the positions of the points are sorted the same way (ties on the position), so the first position of each distinct point gives the vertex back as an index into the set
+bool sets_delaunay(const point_sets& sets, int threads, index_sets& triangles)
+{
+	STATS_SPAN("sets_delaunay");
+	vector<int>().swap(triangles.start);
+	vector<int>().swap(triangles.index);
+	if (!sets_check(sets))
+		return false;
+
+	int n = sets_count(sets);
+	threads = max(1, threads);
+	vector<set_worker> workers(threads);
+	vector<set_result> results(n);
+
+	pool_run(n, threads, SETS_GRAIN, [&](int t, int lo, int hi)
+	{
+		set_worker& w = workers[t];
+		for (int s = lo; s < hi; s++)
+		{
+			load_set(sets, s, w);
+			delaunay(w.points, w.mesh);
+
+			//find the first position of each distinct point, in the same order as the vertices of the mesh
+			const vector<point>& p = w.points;
+			w.order.resize(p.size());
+			for (int i = 0; i < w.order.size(); i++)
+				w.order[i] = i;
+			sort(w.order.begin(), w.order.end(), [&](int i, int j) { return point_less(p[i], p[j]) || (!point_less(p[j], p[i]) && i < j); });
+
+			w.first.clear();
+			for (int k = 0; k < w.order.size(); k++)
+			{
+				point q = p[w.order[k]];
+				if (k == 0 || q.x != p[w.order[k - 1]].x || q.y != p[w.order[k - 1]].y)
+					w.first.push_back(w.order[k]);
+			}
+
+			//turn the vertex of each half edge into its position in the set
+			for (int& v : w.mesh.origin)
+				v = w.first[v];
+			keep_result(workers, t, s, w.mesh.origin.begin(), w.mesh.origin.end(), results);
+		}
+	});
+
+	pack_results(workers, results, triangles);
+	return true;
+}
@@ -0,0 +1,50 @@
+/* These are the batched hull and triangulation, for running them on many small point sets (like one for each object in a scene) in one call.
+* The sets are packed one after the other in a single point array, with the start of each one in an offset array (compressed sparse rows),
+* and the results come back packed the same way, so a million sets take a handful of arrays instead of a million vectors.
+* The sets are shared out between threads by the work stealing pool (see pool.h), and each thread reuses its own temporary arrays from one set to the next,
+* so a set costs nothing on top of its own hull or triangulation.
+*/
+
+#pragma once
+
+#include <vector>
+#include "geometry.h"
+
+//the number of sets a thread takes from the pool at a time
+const int SETS_GRAIN = 64;
+
+//the point sets structure, many point sets packed one after the other
+typedef struct
+{
+	std::vector<int> start; //where each set starts in points, set s being [start[s], start[s + 1]), with one more entry than there are sets (or none at all)
+	std::vector<point> points; //the points of every set, one set after the other
+} point_sets;
+
+//the index sets structure, a list of indices for each of a number of point sets, packed the same way
+typedef struct
+{
+	std::vector<int> start; //where each list starts in index, list s being [start[s], start[s + 1]), with one more entry than there are lists
+	std::vector<int> index; //the indices in every list, each one into the points of its own set (0 being the first point of the set)
+} index_sets;
+
+//this method clears the point sets, so there are none
+void sets_clear(point_sets& s);
+
+//this method adds a set of n points to the end of the point sets
+void sets_add(point_sets& s, const point* points, int n);
+
+//this method returns the number of sets
+int sets_count(const point_sets& s);
+
+//this method checks that the starts of the sets go up from 0 to the number of points, returning false if they don't
+bool sets_check(const point_sets& s);
+
+//this method creates the convex hull of every set with the given algorithm (HULL_QUICK or HULL_MONOTONE), using up to the given number of threads
+//hull s is the ring of the hull vertices of set s, the same as compute_hull on the set on its own, and empty when the set has no hull
+//returns false, with no hulls, if the sets don't pass sets_check
+bool sets_hull(const point_sets& sets, int method, int threads, index_sets& hulls);
+
+//this method creates the delaunay triangulation of every set, using up to the given number of threads
+//list s holds three indices for each triangle of set s, counter clockwise, and when a point is in a set more than once its first copy is used
+//returns false, with no triangles, if the sets don't pass sets_check
+bool sets_delaunay(const point_sets& sets, int threads, index_sets& triangles);
@@ -0,0 +1,243 @@
+/* This is the implementation of the vectorized kernels, with the runtime check that picks between them.
+* See simd.h for what each kernel works out.
+*/
+
+#include "simd.h"
+
+//pick the vector instructions that can be built for this target
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define SIMD_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+//visual studio allows the AVX2 intrinsics in any function, other compilers have to be told which functions use them
+#if defined(SIMD_X86) && !defined(_MSC_VER)
+#define SIMD_AVX2_FUNCTION __attribute__((target("avx2")))
+#else
+#define SIMD_AVX2_FUNCTION
+#endif
+
+//the farthest point kernel types, shared by every version of the kernel, for 32-bit and 16-bit coordinates
+typedef int (*farthest_kernel)(const int* xs, const int* ys, const int* ids, int n, point p1, point p2);
+typedef int (*farthest_kernel16)(const unsigned short* xs, const unsigned short* ys, const int* ids, int n, point p1, point p2);
+
+//the kernel choice structure, set up once the first time a kernel is needed
+typedef struct
+{
+	farthest_kernel farthest; //the farthest point kernel to use for 32-bit coordinates
+	farthest_kernel16 farthest16; //the farthest point kernel to use for 16-bit coordinates
+	const char* name; //the name of the instruction set they use
+} kernel_choice;
+
+//this method is the portable version of the farthest point kernel, in 64-bit integers
+//it is also used for the last few points the vector versions have left over, which is why it takes a starting best
+template <typename T>
+static int farthest_tail(const T* xs, const T* ys, const int* ids, int first, int n, point p1, point p2, int best)
+{
+	long long dx = (long long)p2.x - p1.x, dy = (long long)p2.y - p1.y;
+	long long bestDist = dx * ((long long)ys[best] - p1.y) - dy * ((long long)xs[best] - p1.x);
+
+	for (int i = first; i < n; i++)
+	{
+		long long d = dx * ((long long)ys[i] - p1.y) - dy * ((long long)xs[i] - p1.x);
+		if (d > bestDist || (d == bestDist && ids[i] < ids[best]))
+		{
+			best = i;
+			bestDist = d;
+		}
+	}
+
+	return best;
+}
+
+//this method is the scalar farthest point kernel
+template <typename T>
+static int farthest_scalar(const T* xs, const T* ys, const int* ids, int n, point p1, point p2)
+{
+	return farthest_tail(xs, ys, ids, 1, n, p1, p2, 0);
+}
+
+//this method goes through the lanes of a block of points that a vector kernel found to be at least as far as the best so far
+//distances of the points from position first onwards are in dist, and mask has a bit set for each one that needs checking
+//the best point and its distance are updated in place, breaking ties on the smallest id
+static void update_best(const double* dist, int mask, const int* ids, int first, int& best, double& bestDist)
+{
+	for (int j = 0; mask != 0; j++, mask >>= 1)
+	{
+		if ((mask & 1) && (dist[j] > bestDist || (dist[j] == bestDist && ids[first + j] < ids[best])))
+		{
+			best = first + j;
+			bestDist = dist[j];
+		}
+	}
+}
+
+#ifdef SIMD_X86
+//this method checks if the processor and operating system support AVX2
+static bool has_avx2()
+{
+#ifdef _MSC_VER
+	int info[4];
+	__cpuid(info, 0);
+	if (info[0] < 7)
+		return false;
+
+	//AVX needs the operating system to save the wide registers, which it reports through xgetbv
+	__cpuid(info, 1);
+	if (!(info[2] & (1 << 27)) || !(info[2] & (1 << 28)) || (_xgetbv(0) & 6) != 6)
+		return false;
+
+	__cpuidex(info, 7, 0);
+	return (info[1] & (1 << 5)) != 0;
+#else
+	return __builtin_cpu_supports("avx2");
+#endif
+}
+
+//these methods load eight coordinates into two vectors of four doubles, from 32-bit or 16-bit coordinates
+SIMD_AVX2_FUNCTION static inline void load8(const int* p, __m256d& lo, __m256d& hi)
+{
+	lo = _mm256_cvtepi32_pd(_mm_loadu_si128((const __m128i*)p));
+	hi = _mm256_cvtepi32_pd(_mm_loadu_si128((const __m128i*)(p + 4)));
+}
+
+SIMD_AVX2_FUNCTION static inline void load8(const unsigned short* p, __m256d& lo, __m256d& hi)
+{
+	__m128i v = _mm_loadu_si128((const __m128i*)p);
+	lo = _mm256_cvtepi32_pd(_mm_cvtepu16_epi32(v));
+	hi = _mm256_cvtepi32_pd(_mm_cvtepu16_epi32(_mm_srli_si128(v, 8)));
+}
+
+//this method is the AVX2 farthest point kernel, working on eight points at a time
+//the distances of each block are compared with the best distance so far all at once, and only a block with a point at least as far is looked at lane by lane
+//the best point changes rarely, so the loop has no dependency from one block to the next and the branch is almost always predicted
+template <typename T>
+SIMD_AVX2_FUNCTION static int farthest_avx2(const T* xs, const T* ys, const int* ids, int n, point p1, point p2)
+{
+	__m256d dx = _mm256_set1_pd((double)p2.x - p1.x), dy = _mm256_set1_pd((double)p2.y - p1.y);
+	__m256d ox = _mm256_set1_pd(p1.x), oy = _mm256_set1_pd(p1.y);
+
+	int best = 0;
+	double bestDist = ((double)p2.x - p1.x) * ((double)ys[0] - p1.y) - ((double)p2.y - p1.y) * ((double)xs[0] - p1.x);
+	__m256d bestSplat = _mm256_set1_pd(bestDist);
+
+	int i = 0;
+	for (; i + 8 <= n; i += 8)
+	{
+		__m256d x0, y0, x1, y1;
+		load8(xs + i, x0, x1);
+		load8(ys + i, y0, y1);
+		__m256d d0 = _mm256_sub_pd(_mm256_mul_pd(dx, _mm256_sub_pd(y0, oy)), _mm256_mul_pd(dy, _mm256_sub_pd(x0, ox)));
+		__m256d d1 = _mm256_sub_pd(_mm256_mul_pd(dx, _mm256_sub_pd(y1, oy)), _mm256_mul_pd(dy, _mm256_sub_pd(x1, ox)));
+
+		int mask = _mm256_movemask_pd(_mm256_cmp_pd(d0, bestSplat, _CMP_GE_OQ)) | _mm256_movemask_pd(_mm256_cmp_pd(d1, bestSplat, _CMP_GE_OQ)) << 4;
+		if (mask != 0)
+		{
+			double dist[8];
+			_mm256_storeu_pd(dist, d0);
+			_mm256_storeu_pd(dist + 4, d1);
+			update_best(dist, mask, ids, i, best, bestDist);
+			bestSplat = _mm256_set1_pd(bestDist);
+		}
+	}
+
+	return farthest_tail(xs, ys, ids, i, n, p1, p2, best);
+}
+#endif
+
+#ifdef SIMD_NEON
+//these methods load four coordinates into two vectors of two doubles, from 32-bit or 16-bit coordinates
+static inline void load4(const int* p, float64x2_t& lo, float64x2_t& hi)
+{
+	int32x4_t v = vld1q_s32(p);
+	lo = vcvtq_f64_s64(vmovl_s32(vget_low_s32(v)));
+	hi = vcvtq_f64_s64(vmovl_high_s32(v));
+}
+
+static inline void load4(const unsigned short* p, float64x2_t& lo, float64x2_t& hi)
+{
+	uint32x4_t v = vmovl_u16(vld1_u16(p));
+	lo = vcvtq_f64_u64(vmovl_u32(vget_low_u32(v)));
+	hi = vcvtq_f64_u64(vmovl_high_u32(v));
+}
+
+//this method is the NEON farthest point kernel, working on four points at a time
+//it works the same way as the AVX2 kernel, only looking lane by lane at a block with a point at least as far as the best so far
+template <typename T>
+static int farthest_neon(const T* xs, const T* ys, const int* ids, int n, point p1, point p2)
+{
+	float64x2_t dx = vdupq_n_f64((double)p2.x - p1.x), dy = vdupq_n_f64((double)p2.y - p1.y);
+	float64x2_t ox = vdupq_n_f64(p1.x), oy = vdupq_n_f64(p1.y);
+
+	int best = 0;
+	double bestDist = ((double)p2.x - p1.x) * ((double)ys[0] - p1.y) - ((double)p2.y - p1.y) * ((double)xs[0] - p1.x);
+	float64x2_t bestSplat = vdupq_n_f64(bestDist);
+
+	int i = 0;
+	for (; i + 4 <= n; i += 4)
+	{
+		float64x2_t x0, y0, x1, y1;
+		load4(xs + i, x0, x1);
+		load4(ys + i, y0, y1);
+		float64x2_t d0 = vsubq_f64(vmulq_f64(dx, vsubq_f64(y0, oy)), vmulq_f64(dy, vsubq_f64(x0, ox)));
+		float64x2_t d1 = vsubq_f64(vmulq_f64(dx, vsubq_f64(y1, oy)), vmulq_f64(dy, vsubq_f64(x1, ox)));
+
+		uint64x2_t ge0 = vcgeq_f64(d0, bestSplat), ge1 = vcgeq_f64(d1, bestSplat);
+		int mask = (int)(vgetq_lane_u64(ge0, 0) & 1) | (int)(vgetq_lane_u64(ge0, 1) & 2) | (int)(vgetq_lane_u64(ge1, 0) & 4) | (int)(vgetq_lane_u64(ge1, 1) & 8);
+		if (mask != 0)
+		{
+			double dist[4];
+			vst1q_f64(dist, d0);
+			vst1q_f64(dist + 2, d1);
+			update_best(dist, mask, ids, i, best, bestDist);
+			bestSplat = vdupq_n_f64(bestDist);
+		}
+	}
+
+	return farthest_tail(xs, ys, ids, i, n, p1, p2, best);
+}
+#endif
+
+//this method picks the widest kernel the machine supports
+static kernel_choice pick_kernels()
+{
+#ifdef SIMD_X86
+	if (has_avx2())
+		return kernel_choice{ farthest_avx2<int>, farthest_avx2<unsigned short>, "avx2" };
+#endif
+#ifdef SIMD_NEON
+	return kernel_choice{ farthest_neon<int>, farthest_neon<unsigned short>, "neon" };
+#endif
+	return kernel_choice{ farthest_scalar<int>, farthest_scalar<unsigned short>, "scalar" };
+}
+
+//this method returns the kernels to use, which are picked the first time it is called (safely, even from several threads at once)
+static const kernel_choice& kernels()
+{
+	static const kernel_choice choice = pick_kernels();
+	return choice;
+}
+
+//this method returns the position in [0, n) of the point farthest to the left of the line from p1 to p2
+int farthest_from_line(const int* xs, const int* ys, const int* ids, int n, point p1, point p2)
+{
+	return kernels().farthest(xs, ys, ids, n, p1, p2);
+}
+
+//this method is the same as farthest_from_line, for 16-bit coordinates
+int farthest_from_line(const unsigned short* xs, const unsigned short* ys, const int* ids, int n, point p1, point p2)
+{
+	return kernels().farthest16(xs, ys, ids, n, p1, p2);
+}
+
+//this method returns the name of the instruction set the kernels are using: "avx2", "neon" or "scalar"
+const char* simd_kernel_name()
+{
+	return kernels().name;
+}
@@ -0,0 +1,25 @@
+/* These are the vectorized kernels for the hot scans of the hull algorithms.
+* The points are given as struct of arrays (separate x and y arrays, of 32-bit or 16-bit coordinates), so each kernel reads them in order, several points at a time.
+* Each kernel has an AVX2 version (x86), a NEON version (ARM64) and a portable scalar version, and the widest one the machine supports is picked at runtime.
+* The kernels work in doubles, which are exact as long as every coordinate is within SIMD_COORD_LIMIT, so they give the same answer as the int predicates.
+*/
+
+#pragma once
+
+#include "geometry.h"
+
+//every coordinate given to the kernels must be strictly within this limit (either side of 0)
+//differences are then below 2^26 and their products below 2^52, so the distances are exact in a double
+const int SIMD_COORD_LIMIT = 1 << 25;
+
+//this method returns the position in [0, n) of the point farthest to the left of the line from p1 to p2
+//the points are (xs[i], ys[i]), and ties are broken on the smallest ids[i], so the answer does not depend on the order of the points
+//n must be at least 1
+int farthest_from_line(const int* xs, const int* ys, const int* ids, int n, point p1, point p2);
+
+//this method is the same as farthest_from_line, for 16-bit coordinates (like the offsets in a compact point store), which halves the memory it reads
+//p1 and p2 have to be given relative to the same origin as the coordinates
+int farthest_from_line(const unsigned short* xs, const unsigned short* ys, const int* ids, int n, point p1, point p2);
+
+//this method returns the name of the instruction set the kernels are using: "avx2", "neon" or "scalar"
+const char* simd_kernel_name();
@@ -0,0 +1,224 @@
+/* This is the implementation of the instrumentation.
+* See stats.h for what is counted and timed.
+*/
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include "stats.h"
+using namespace std;
+
+//the names of the counters, in the same order as the STAT enums
+static const char* statNames[STAT_COUNT] = {
+	"orient2d", "incircle", "quick_hull_runs", "quick_hull_ranges", "quick_hull_scanned", "quick_hull_max_depth", "peel_layers",
+	"insert_trisects", "insert_edge_splits", "insert_outside", "legalize_tests", "legalize_flips", "cleanup_tests", "cleanup_flips",
+	"constrain_edges", "constrain_flips"
+};
+
+//the shared stats structure, the blocks of the threads that have ended added together, and the blocks of the threads still running
+typedef struct
+{
+	mutex lock; //held while the shared stats or the list of blocks change
+	vector<stats_block*> live; //the blocks of the threads still running
+	long long counts[STAT_COUNT]; //the counters of the threads that have ended
+	vector<stats_span_event> spans; //the spans of the threads that have ended
+	vector<stats_phase> phases; //the totals of each phase over the threads that have ended
+	long long dropped; //the spans of the threads that have ended that were only added to the totals
+	int threads; //the number of threads that have made a block
+} stats_shared;
+
+//this method returns the shared stats, made the first time they are needed so they are there before any thread makes its block
+static stats_shared& shared_stats()
+{
+	static stats_shared s;
+	return s;
+}
+
+//this method sets a block or the shared stats back to nothing counted
+static void zero_stats(long long counts[STAT_COUNT], vector<stats_span_event>& spans, vector<stats_phase>& phases, long long& dropped)
+{
+	fill(counts, counts + STAT_COUNT, 0);
+	spans.clear();
+	phases.clear();
+	dropped = 0;
+}
+
+//this method adds the time of one span to the totals of its phase, adding the phase if it isn't in the list yet
+//phases are matched on their names rather than the pointers, as the same literal in two files can be two copies
+static void add_phase(vector<stats_phase>& phases, const char* name, long long count, long long total, long long longest)
+{
+	for (stats_phase& p : phases)
+	{
+		if (p.name == name || strcmp(p.name, name) == 0)
+		{
+			p.count += count;
+			p.total += total;
+			p.longest = max(p.longest, longest);
+			return;
+		}
+	}
+
+	phases.push_back(stats_phase{ name, count, total, longest });
+}
+
+//this method adds the counters, spans and phases of a block into the given totals, taking the larger of the max counters
+static void add_block(long long counts[STAT_COUNT], vector<stats_span_event>& spans, vector<stats_phase>& phases, long long& dropped, const stats_block& b)
+{
+	for (int k = 0; k < STAT_COUNT; k++)
+		counts[k] = k == STAT_HULL_DEPTH ? max(counts[k], b.counts[k]) : counts[k] + b.counts[k];
+
+	spans.insert(spans.end(), b.spans.begin(), b.spans.end());
+	for (const stats_phase& p : b.phases)
+		add_phase(phases, p.name, p.count, p.total, p.longest);
+	dropped += b.dropped;
+}
+
+//this method makes the block of a thread, numbering the thread and adding the block to the live blocks
+stats_block::stats_block()
+{
+	zero_stats(counts, spans, phases, dropped);
+
+	stats_shared& s = shared_stats();
+	lock_guard<mutex> hold(s.lock);
+	thread = s.threads++;
+	s.live.push_back(this);
+}
+
+//this method adds the block of a thread that is ending into the shared stats
+stats_block::~stats_block()
+{
+	stats_shared& s = shared_stats();
+	lock_guard<mutex> hold(s.lock);
+	add_block(s.counts, s.spans, s.phases, s.dropped, *this);
+	s.live.erase(remove(s.live.begin(), s.live.end(), this), s.live.end());
+}
+
+//this method returns the time in nanoseconds from when the stats started, which is the first time this is called
+long long stats_now()
+{
+	static const chrono::steady_clock::time_point epoch = chrono::steady_clock::now();
+	return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - epoch).count();
+}
+
+//this method adds a finished span to the block of the calling thread
+//once the thread has kept STATS_SPAN_MAX spans, the rest only go into the totals of their phase
+void stats_end_span(const char* name, long long start)
+{
+	long long duration = stats_now() - start;
+	stats_block& b = stats_here();
+
+	if (b.spans.size() < STATS_SPAN_MAX)
+		b.spans.push_back(stats_span_event{ name, start, duration, b.thread });
+	else
+		b.dropped++;
+	add_phase(b.phases, name, 1, duration, duration);
+}
+
+//this method returns the name of counter k, as used in the exports
+const char* stats_name(int k)
+{
+	return statNames[k];
+}
+
+//this method zeroes every counter and throws away every span, on every thread
+void stats_reset()
+{
+	stats_shared& s = shared_stats();
+	lock_guard<mutex> hold(s.lock);
+	zero_stats(s.counts, s.spans, s.phases, s.dropped);
+	for (stats_block* b : s.live)
+		zero_stats(b->counts, b->spans, b->phases, b->dropped);
+}
+
+//this method adds up the stats of every thread, the ones that have ended and the ones still running, with the spans in the order they started
+static void gather_stats(long long counts[STAT_COUNT], vector<stats_span_event>& spans, vector<stats_phase>& phases, long long& dropped)
+{
+	zero_stats(counts, spans, phases, dropped);
+
+	stats_shared& s = shared_stats();
+	lock_guard<mutex> hold(s.lock);
+	for (int k = 0; k < STAT_COUNT; k++)
+		counts[k] = s.counts[k];
+	spans = s.spans;
+	phases = s.phases;
+	dropped = s.dropped;
+
+	for (const stats_block* b : s.live)
+		add_block(counts, spans, phases, dropped, *b);
+
+	sort(spans.begin(), spans.end(), [](const stats_span_event& a, const stats_span_event& b) { return a.start < b.start; });
+}
+
+//this method fills counts with the totals of every counter, over the threads that have ended and the ones still running
+void stats_totals(long long counts[STAT_COUNT])
+{
+	vector<stats_span_event> spans;
+	vector<stats_phase> phases;
+	long long dropped;
+	gather_stats(counts, spans, phases, dropped);
+}
+
+//this method writes the totals of the counters and of each phase to a JSON file at path
+//the phases give the number of spans and their total and longest times in milliseconds
+bool stats_write_json(const string& path)
+{
+	long long counts[STAT_COUNT];
+	vector<stats_span_event> spans;
+	vector<stats_phase> phases;
+	long long dropped;
+	gather_stats(counts, spans, phases, dropped);
+
+	ofstream out(path);
+	if (!out)
+		return false;
+
+	out << "{\n  \"counters\": {\n";
+	for (int k = 0; k < STAT_COUNT; k++)
+		out << "    \"" << statNames[k] << "\": " << counts[k] << (k + 1 < STAT_COUNT ? ",\n" : "\n");
+
+	out << "  },\n  \"phases\": {\n";
+	for (int i = 0; i < phases.size(); i++)
+	{
+		const stats_phase& p = phases[i];
+		out << "    \"" << p.name << "\": { \"count\": " << p.count << ", \"total_ms\": " << p.total / 1e6 << ", \"longest_ms\": " << p.longest / 1e6 << " }"
+			<< (i + 1 < phases.size() ? ",\n" : "\n");
+	}
+	out << "  },\n  \"spans_dropped\": " << dropped << "\n}\n";
+
+	return (bool)out;
+}
+
+//this method writes every span and the totals of the counters to a Chrome trace at path
+//each span is a complete event on the thread that ran it, with times in microseconds, and the counters are one counter event after the last span
+bool stats_write_trace(const string& path)
+{
+	long long counts[STAT_COUNT];
+	vector<stats_span_event> spans;
+	vector<stats_phase> phases;
+	long long dropped;
+	gather_stats(counts, spans, phases, dropped);
+
+	ofstream out(path);
+	if (!out)
+		return false;
+
+	out << fixed;
+	out.precision(3);
+
+	long long end = 0;
+	out << "{\"traceEvents\":[\n";
+	for (const stats_span_event& e : spans)
+	{
+		out << "{\"name\":\"" << e.name << "\",\"cat\":\"geometry\",\"ph\":\"X\",\"pid\":1,\"tid\":" << e.thread
+			<< ",\"ts\":" << e.start / 1e3 << ",\"dur\":" << e.duration / 1e3 << "},\n";
+		end = max(end, e.start + e.duration);
+	}
+
+	out << "{\"name\":\"counters\",\"cat\":\"geometry\",\"ph\":\"C\",\"pid\":1,\"tid\":0,\"ts\":" << end / 1e3 << ",\"args\":{";
+	for (int k = 0; k < STAT_COUNT; k++)
+		out << (k > 0 ? "," : "") << "\"" << statNames[k] << "\":" << counts[k];
+	out << "}}\n],\"displayTimeUnit\":\"ms\"}\n";
+
+	return (bool)out;
+}
@@ -0,0 +1,135 @@
+/* This is the instrumentation of the geometry operations: counters on the hot paths, and timed spans for the phases of each operation.
+* The counters say how much work a run did (orientation tests, points scanned by quick hull, flips tried and made and so on),
+* so a slow run can be put down to the points it was given (more work) or to a regression (the same work, taking longer).
+* Each thread counts into its own block, so a counter costs one add and never takes a lock,
+* and the block of a thread is added into the totals when the thread ends (like the threads of a parallel hull, the pool or a job).
+* The totals can be written out as JSON, or as a Chrome trace that chrome://tracing or Perfetto shows with each span on the thread that ran it.
+* Defining GEOMETRY_NO_STATS (for every project that includes these headers) compiles the counting out, as the STATS macros then do nothing,
+* and the exports only write zeros.
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <chrono>
+
+//enums for the counters, in the same order as their names in the exports
+enum {
+	STAT_ORIENT, //orientation tests (orient2d)
+	STAT_INCIRCLE, //incircle tests
+	STAT_HULL_RUNS, //quick hulls run
+	STAT_HULL_RANGES, //ranges taken off the quick hull stack, each one a scan for the farthest point or an edge of the hull
+	STAT_HULL_SCANNED, //points scanned by the quick hull farthest point scans
+	STAT_HULL_DEPTH, //the deepest range of any quick hull, in splits from the first line (a max rather than a sum)
+	STAT_PEEL_LAYERS, //hull layers peeled
+	STAT_INSERT_TRISECTS, //points inserted into a triangle, splitting it into three
+	STAT_INSERT_EDGE_SPLITS, //points inserted onto an edge, splitting the triangles either side of it into two
+	STAT_INSERT_OUTSIDE, //points inserted outside the hull of the triangulation
+	STAT_LEGALIZE_TESTS, //edges tested by the legalize of the sweep hull and the insert
+	STAT_LEGALIZE_FLIPS, //edges flipped by the legalize
+	STAT_CLEANUP_TESTS, //edges tested by the cleanup
+	STAT_CLEANUP_FLIPS, //edges flipped by the cleanup
+	STAT_CONSTRAIN_EDGES, //constraint edges put into a triangulation
+	STAT_CONSTRAIN_FLIPS, //edges flipped to put the constraint edges in, and to make the edges around them delaunay again
+	STAT_COUNT
+};
+
+//the largest number of spans kept for the trace on each thread, past which spans are only added to the totals of their phase
+const int STATS_SPAN_MAX = 1 << 20;
+
+//the stats span structure, one timed run of a phase
+typedef struct
+{
+	const char* name; //the name of the phase, which has to outlive the stats (a string literal)
+	long long start; //when the span started, in nanoseconds from when the stats started
+	long long duration; //how long the span took, in nanoseconds
+	int thread; //the number of the thread that ran it, counting from 0 in the order the threads first used the stats
+} stats_span_event;
+
+//the stats phase structure, the totals of every span of one phase
+typedef struct
+{
+	const char* name; //the name of the phase
+	long long count; //the number of spans
+	long long total; //the time of every span added together, in nanoseconds
+	long long longest; //the time of the longest span, in nanoseconds
+} stats_phase;
+
+//the stats block structure, what one thread has counted since it started (or since the last reset)
+//a thread makes its block the first time it counts anything, and adds it into the totals when the thread ends
+struct stats_block
+{
+	long long counts[STAT_COUNT]; //the counters
+	std::vector<stats_span_event> spans; //the spans for the trace, up to STATS_SPAN_MAX of them
+	std::vector<stats_phase> phases; //the totals of each phase, in the order the phases were first run
+	long long dropped; //the number of spans past STATS_SPAN_MAX, only in the totals of their phases
+	int thread; //the number of the thread
+
+	stats_block();
+	~stats_block();
+};
+
+//this method returns the block of the calling thread, making it the first time it is called on that thread
+inline stats_block& stats_here()
+{
+	static thread_local stats_block block;
+	return block;
+}
+
+//this method counts the value into the max counter k of the calling thread
+inline void stats_max(int k, long long value)
+{
+	stats_block& b = stats_here();
+	if (value > b.counts[k])
+		b.counts[k] = value;
+}
+
+//this method returns the time in nanoseconds from when the stats started
+long long stats_now();
+
+//this method adds a finished span to the block of the calling thread
+void stats_end_span(const char* name, long long start);
+
+//the stats timer structure, which times a span of a phase from when it is made to when it goes out of scope
+struct stats_timer
+{
+	const char* name; //the name of the phase
+	long long start; //when the span started
+
+	stats_timer(const char* phase) : name(phase), start(stats_now()) {}
+	~stats_timer() { stats_end_span(name, start); }
+};
+
+//the macros the operations count and time with, which do nothing when the stats are compiled out
+//STATS_SPAN times the rest of the scope it is in, so it has to be the first thing in the scope to time all of it
+#ifndef GEOMETRY_NO_STATS
+#define STATS_ADD(k, n) (stats_here().counts[k] += (n))
+#define STATS_MAX(k, v) stats_max(k, v)
+#define STATS_JOIN(a, b) a##b
+#define STATS_NAME(line) STATS_JOIN(statsTimer, line)
+#define STATS_SPAN(name) stats_timer STATS_NAME(__LINE__)(name)
+#else
+#define STATS_ADD(k, n) ((void)0)
+#define STATS_MAX(k, v) ((void)0)
+#define STATS_SPAN(name) ((void)0)
+#endif
+
+//this method returns the name of counter k, as used in the exports
+const char* stats_name(int k);
+
+//this method zeroes every counter and throws away every span, on every thread
+//it must not be called while a geometry operation is running on another thread
+void stats_reset();
+
+//this method fills counts with the totals of every counter, over the threads that have ended and the ones still running
+//it must not be called while a geometry operation is running on another thread, as their blocks are read without a lock
+void stats_totals(long long counts[STAT_COUNT]);
+
+//this method writes the totals of the counters and of each phase to a JSON file at path
+//returns false if the file cannot be written
+bool stats_write_json(const std::string& path);
+
+//this method writes every span and the totals of the counters to a Chrome trace (JSON trace event format) at path
+//returns false if the file cannot be written
+bool stats_write_trace(const std::string& path);
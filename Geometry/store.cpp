@@ -0,0 +1,94 @@
+/* This is the implementation of the point store.
+* See store.h for how the points are laid out.
+*/
+
+#include <algorithm>
+#include "store.h"
+using namespace std;
+
+//this method clears the store, getting rid of its points and freeing its memory
+void store_clear(point_store& s)
+{
+	s.count = 0;
+	s.compact = false;
+	s.origin = point{ 0, 0 };
+	vector<int>().swap(s.xs);
+	vector<int>().swap(s.ys);
+	vector<unsigned short>().swap(s.cx);
+	vector<unsigned short>().swap(s.cy);
+}
+
+//this method fills the store with the points, in the same order, so the indices the algorithms give back are indices into points
+//the extents of the points are found first, and the store is only compact if both of them are under STORE_COMPACT_RANGE
+//returns true if the store is compact
+bool store_build(point_store& s, const vector<point>& points, bool compact)
+{
+	store_clear(s);
+	s.count = points.size();
+
+	if (compact && !points.empty())
+	{
+		//find the extents of the points
+		int xMin = points[0].x, yMin = points[0].y, xMax = points[0].x, yMax = points[0].y;
+		for (const point& p : points)
+		{
+			xMin = min(xMin, p.x);
+			yMin = min(yMin, p.y);
+			xMax = max(xMax, p.x);
+			yMax = max(yMax, p.y);
+		}
+
+		s.compact = (long long)xMax - xMin < STORE_COMPACT_RANGE && (long long)yMax - yMin < STORE_COMPACT_RANGE;
+		if (s.compact)
+			s.origin = point{ xMin, yMin };
+	}
+
+	if (s.compact)
+	{
+		s.cx.resize(s.count);
+		s.cy.resize(s.count);
+		for (int i = 0; i < s.count; i++)
+		{
+			s.cx[i] = (unsigned short)(points[i].x - s.origin.x);
+			s.cy[i] = (unsigned short)(points[i].y - s.origin.y);
+		}
+	}
+	else
+	{
+		s.xs.resize(s.count);
+		s.ys.resize(s.count);
+		for (int i = 0; i < s.count; i++)
+		{
+			s.xs[i] = points[i].x;
+			s.ys[i] = points[i].y;
+		}
+	}
+
+	return s.compact;
+}
+
+//this method returns a view of the points in the store, which is only valid until the store changes
+point_view store_view(const point_store& s)
+{
+	point_view v = { s.count, s.compact, s.origin, NULL, NULL, NULL, NULL };
+	if (s.compact)
+	{
+		v.cx = s.cx.data();
+		v.cy = s.cy.data();
+	}
+	else
+	{
+		v.xs = s.xs.data();
+		v.ys = s.ys.data();
+	}
+
+	return v;
+}
+
+//this method copies the points in the view out into points
+void view_points(const point_view& v, vector<point>& points)
+{
+	points.resize(v.count);
+	for (int i = 0; i < v.count; i++)
+		points[i] = view_get(v, i);
+}
@@ -0,0 +1,72 @@
+/* This is the point store, a struct of arrays copy of a set of points for the hull, peel and triangulation to run on.
+* The x and y coordinates are kept in separate arrays, so a scan over one axis reads only that axis, in order.
+* When every point fits in a 65536 by 65536 box (as window coordinates always do), the store can be compact,
+* keeping each coordinate as a 16-bit offset from the bottom left corner of the box, which halves the memory every scan reads.
+* The offsets are exact, not rounded, so the algorithms give the same answers on a compact store as on the points it came from.
+* The algorithms run on a point view, which reads the same arrays without owning them, so they can also run straight on a memory mapped file.
+*/
+
+#pragma once
+
+#include <vector>
+#include "geometry.h"
+
+//the width and height of the largest box of points a compact store can hold
+const int STORE_COMPACT_RANGE = 1 << 16;
+
+//the point store structure
+//only one pair of coordinate arrays is used: xs and ys when the store is wide, or cx and cy when it is compact
+typedef struct
+{
+	int count; //the number of points in the store
+	bool compact; //true when the coordinates are kept as 16-bit offsets
+	point origin; //the bottom left corner the offsets are from, (0, 0) for a wide store
+	std::vector<int> xs, ys; //the coordinates of each point, for a wide store
+	std::vector<unsigned short> cx, cy; //the offsets of each point from the origin, for a compact store
+} point_store;
+
+//this method clears the store, getting rid of its points and freeing its memory
+void store_clear(point_store& s);
+
+//this method fills the store with the points, in the same order, so the indices the algorithms give back are indices into points
+//the store is compact if compact is true and the points fit, otherwise it is wide
+//returns true if the store is compact
+bool store_build(point_store& s, const std::vector<point>& points, bool compact);
+
+//this method returns point i of the store
+inline point store_get(const point_store& s, int i)
+{
+	if (s.compact)
+		return point{ s.origin.x + s.cx[i], s.origin.y + s.cy[i] };
+
+	return point{ s.xs[i], s.ys[i] };
+}
+
+//the point view structure, a read only look at points laid out the same way as a point store, without owning them
+//a view can be taken of a point store, or of the arrays in a memory mapped file (see geofile.h), so the algorithms run on either without a copy
+//only one pair of coordinate arrays is set: xs and ys when the view is wide, or cx and cy when it is compact
+typedef struct
+{
+	int count; //the number of points in the view
+	bool compact; //true when the coordinates are 16-bit offsets
+	point origin; //the bottom left corner the offsets are from, (0, 0) for a wide view
+	const int* xs; //the x coordinate of each point, for a wide view
+	const int* ys; //the y coordinate of each point, for a wide view
+	const unsigned short* cx; //the x offset of each point from the origin, for a compact view
+	const unsigned short* cy; //the y offset of each point from the origin, for a compact view
+} point_view;
+
+//this method returns a view of the points in the store, which is only valid until the store changes
+point_view store_view(const point_store& s);
+
+//this method returns point i of the view
+inline point view_get(const point_view& v, int i)
+{
+	if (v.compact)
+		return point{ v.origin.x + v.cx[i], v.origin.y + v.cy[i] };
+
+	return point{ v.xs[i], v.ys[i] };
+}
+
+//this method copies the points in the view out into points
+void view_points(const point_view& v, std::vector<point>& points);
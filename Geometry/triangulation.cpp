@@ -0,0 +1,1226 @@
+/* This is the implementation of the delaunay triangulation and the edge flip cleanup.
+* See triangulation.h for what each one does to the mesh.
+*/
+
+#include <algorithm>
+#include <thread>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+#include "triangulation.h"
+#include "predicates.h"
+#include "stats.h"
+using namespace std;
+
+//this method legalizes the edges on the stack, flipping any edge that is not delaunay
+//each entry is a half edge, with the opposite vertex in its triangle being the point that was just added
+//if the vertex on the other side of the edge is inside the circle of the triangle, the edge is flipped and the two new edges opposite the point are checked
+//points on the same circle are left alone, so lattices do not flip back and forth forever
+//hullEdge holds the half edge on the hull going out of each hull vertex, which is kept up to date as hull edges move between triangles
+//when hullEdge is empty, no hull is being tracked, and only the flips are made
+static void legalize(halfedge_mesh& m, vector<int>& stack, vector<int>& hullEdge)
+{
+	while (!stack.empty())
+	{
+		int h = stack.back();
+		stack.pop_back();
+
+		int g = m.twin[h];
+		if (g == -1)
+			continue;
+
+		//the edge goes from a to b, with c opposite it and d opposite it in the other triangle
+		int a = m.origin[h], b = m.origin[he_next(m, h)], c = m.origin[he_prev(m, h)];
+		int d = m.origin[he_prev(m, g)];
+
+		STATS_ADD(STAT_LEGALIZE_TESTS, 1);
+		if (incircle(m.points[a], m.points[b], m.points[c], m.points[d]) <= 0)
+			continue;
+
+		he_flip(m, h);
+		STATS_ADD(STAT_LEGALIZE_FLIPS, 1);
+
+		//keep track of which half edge each hull edge of the quad is now in
+		int t = h - h % 3, n = g - g % 3;
+		if (!hullEdge.empty())
+		{
+			if (m.twin[t] == -1)
+				hullEdge[c] = t;
+			if (m.twin[t + 1] == -1)
+				hullEdge[a] = t + 1;
+			if (m.twin[n + 1] == -1)
+				hullEdge[d] = n + 1;
+			if (m.twin[n + 2] == -1)
+				hullEdge[b] = n + 2;
+		}
+
+		//check the two edges opposite the point c
+		stack.push_back(t + 1);
+		stack.push_back(n + 1);
+	}
+}
+
+//this method returns the pseudo angle of the direction (dx, dy), a number in [0, 1) that grows with the angle going counter clockwise
+//it is only used to pick a place to start looking on the hull, so it doesn't have to be exact, just never go down as the angle goes up
+static double pseudo_angle(double dx, double dy)
+{
+	double p = dx / (fabs(dx) + fabs(dy));
+	return (dy > 0 ? 3 - p : 1 + p) / 4;
+}
+
+//this method fills order with the indices of the points sorted by their distance from point seed, nearest first, with ties on the smallest index
+//the distances are compared exactly: as squared 64-bit lengths when the points span less than 2^31 each way, and otherwise with compare_length
+static void radial_order(const vector<point>& points, int seed, vector<int>& order)
+{
+	STATS_SPAN("sweep_order");
+	int n = points.size();
+	point c = points[seed];
+	vector<int>(n).swap(order);
+
+	long long span = 0;
+	for (const point& p : points)
+		span = max(span, max(llabs((long long)p.x - c.x), llabs((long long)p.y - c.y)));
+
+	if (span < (1LL << 31))
+	{
+		vector<pair<long long, int>> keys(n);
+		for (int i = 0; i < n; i++)
+		{
+			long long dx = (long long)points[i].x - c.x, dy = (long long)points[i].y - c.y;
+			keys[i] = make_pair(dx * dx + dy * dy, i);
+		}
+		sort(keys.begin(), keys.end());
+		for (int i = 0; i < n; i++)
+			order[i] = keys[i].second;
+		return;
+	}
+
+	for (int i = 0; i < n; i++)
+		order[i] = i;
+	sort(order.begin(), order.end(), [&](int i, int j)
+	{
+		int cmp = compare_length(c, points[i], c, points[j]);
+		return cmp < 0 || (cmp == 0 && i < j);
+	});
+}
+
+//this method triangulates the points of the mesh with a radial sweep hull (s-hull), the points having already been sorted by x then y without duplicates
+//the points are added in order of their distance from a seed point, the one nearest the middle of their bounding box, found with radial_order
+//every point so far is no further from the seed than the new one, so the hull of them is inside the circle the new point is on, and it is always outside the hull
+//the first points are fanned to the first point that is not colinear with them, then each point after that is joined to all the hull edges it can see,
+//which are found by walking the hull both ways from a visible edge near it, and the old hull edges are legalized with edge flips, keeping the triangulation delaunay
+//the hull stays round around the seed, so a new point only sees a short stretch of it and few flips are needed after it,
+//where in x order each point sees a long thin stretch of hull and the flips per point grow with the number of points
+//a visible edge is found by starting from the hull vertex in a hash of the hull by pseudo angle around the seed, which is only a hint, as every test on the hull is exact
+//the sort is O(n log n), and the walks and flips average a small constant per point
+//when there is a progress (it can be NULL), each triangle made is counted as a step, and the sweep stops with an empty mesh if it is cancelled
+static bool sweep_hull(halfedge_mesh& m, job_progress* progress)
+{
+	STATS_SPAN("sweep_hull");
+	int n = m.points.size();
+	if (n < 3)
+		return true;
+
+	//a triangulation of n points has fewer than 2n triangles, so the mesh arrays are made big enough for all of them up front instead of growing as they are added
+	m.origin.reserve(6 * (long long)n);
+	m.twin.reserve(6 * (long long)n);
+	m.faceEdge.reserve(2 * (long long)n);
+
+	//the seed is the point nearest the middle of the bounding box, which the rest are added around
+	int xMin = INT_MAX, xMax = INT_MIN, yMin = INT_MAX, yMax = INT_MIN;
+	for (const point& p : m.points)
+	{
+		xMin = min(p.x, xMin);
+		xMax = max(p.x, xMax);
+		yMin = min(p.y, yMin);
+		yMax = max(p.y, yMax);
+	}
+	point middle = point{ (int)(((long long)xMin + xMax) / 2), (int)(((long long)yMin + yMax) / 2) };
+	int seed = 0;
+	for (int i = 1; i < n; i++)
+		if (compare_length(middle, m.points[i], middle, m.points[seed]) < 0)
+			seed = i;
+
+	vector<int> order;
+	radial_order(m.points, seed, order);
+	const int* o = order.data();
+
+	//find the first point that is not colinear with the ones before it, if all the points are colinear there are no triangles
+	int k = 2;
+	while (k < n && orient2d(m.points[o[0]], m.points[o[1]], m.points[o[k]]) == 0)
+		k++;
+	if (k == n)
+		return true;
+
+	//the colinear points go along their line in index order (which is x then y), so each one is next to the one before it
+	sort(order.begin(), order.begin() + k);
+	int seedAt = find(order.begin(), order.begin() + k, seed) - order.begin();
+
+	//the sweep works on the points in the order they are added, so the hull and the new triangles are near each other in memory,
+	//and the vertices are put back to their places in the sorted points once it is done
+	vector<point> sorted;
+	sorted.swap(m.points);
+	m.points.resize(n);
+	for (int i = 0; i < n; i++)
+		m.points[i] = sorted[o[i]];
+
+	//the hull is a counter clockwise list of vertices, with the half edge on the hull going out of each vertex; a vertex that has been covered has no next vertex
+	vector<int> hullNext(n, -1), hullPrev(n, -1), hullEdge(n, -1);
+	vector<int> stack;
+
+	//fan the colinear points to point k, which is the only way to triangulate them, keeping every triangle counter clockwise
+	//triangle i is made from points i, i + 1 and k, linked to the one before it
+	if (orient2d(m.points[0], m.points[1], m.points[k]) > 0)
+	{
+		//point k is on the left, so the hull goes along the colinear points then to k and back to the start
+		for (int i = 0; i + 1 < k; i++)
+		{
+			int t = 3 * he_add_triangle(m, i, i + 1, k);
+			if (i > 0)
+				he_set_twin(m, t + 2, t - 2);
+			hullEdge[i] = t;
+			hullNext[i] = i + 1;
+		}
+		hullNext[k - 1] = k;
+		hullEdge[k - 1] = 3 * (k - 2) + 1;
+		hullNext[k] = 0;
+		hullEdge[k] = 2;
+	}
+	else
+	{
+		//point k is on the right, so the hull goes from the start to k then back along the colinear points
+		for (int i = 0; i + 1 < k; i++)
+		{
+			int t = 3 * he_add_triangle(m, i + 1, i, k);
+			if (i > 0)
+				he_set_twin(m, t + 1, t - 1);
+			hullEdge[i + 1] = t;
+			hullNext[i + 1] = i;
+		}
+		hullNext[0] = k;
+		hullEdge[0] = 1;
+		hullNext[k] = k - 1;
+		hullEdge[k] = 3 * (k - 2) + 2;
+	}
+	for (int i = 0; i <= k; i++)
+		hullPrev[hullNext[i]] = i;
+
+	//the hash of the hull, which holds a hull vertex (or one that used to be) for each range of pseudo angles around the seed, which has no angle so it is left out
+	point centre = m.points[seedAt];
+	int hashSize = (int)ceil(sqrt((double)n));
+	vector<int> hash(hashSize, -1);
+	auto hash_key = [&](point p) { return (int)(pseudo_angle((double)p.x - centre.x, (double)p.y - centre.y) * hashSize) % hashSize; };
+	for (int i = 0; i <= k; i++)
+		if (i != seedAt)
+			hash[hash_key(m.points[i])] = i;
+
+	//count the fan as the first triangles made
+	int faces = he_face_count(m);
+	if (progress != NULL && !job_step(*progress, faces))
+	{
+		he_reset(m);
+		return false;
+	}
+
+	//add the rest of the points, each one is outside the hull
+	for (int i = k + 1; i < n; i++)
+	{
+		point p = m.points[i];
+
+		//start from the hull vertex hashed nearest the angle of the point, or point k of the fan if the hash has nothing on the hull
+		int key = hash_key(p), from = k;
+		for (int j = 0; j < hashSize; j++)
+		{
+			int h = hash[(key + j) % hashSize];
+			if (h != -1 && hullNext[h] != -1)
+			{
+				from = h;
+				break;
+			}
+		}
+
+		//walk forward from the vertex before it to the first visible edge, which there always is, as the point is outside the hull
+		int e = hullPrev[from];
+		while (orient2d(m.points[e], m.points[hullNext[e]], p) >= 0)
+			e = hullNext[e];
+
+		//walk forward and back from that edge to find the ends of the visible part of the hull
+		int end = e;
+		while (orient2d(m.points[end], m.points[hullNext[end]], p) < 0)
+			end = hullNext[end];
+		int start = e;
+		while (orient2d(m.points[hullPrev[start]], m.points[start], p) < 0)
+			start = hullPrev[start];
+
+		//add a triangle (b, a, i) for each visible edge a b, with its first half edge across the old hull edge and its second joined to the triangle before it
+		int prev = -1;
+		for (int a = start; a != end; )
+		{
+			int b = hullNext[a];
+			int t = 3 * he_add_triangle(m, b, a, i);
+			he_set_twin(m, t, hullEdge[a]);
+			if (prev == -1)
+				hullEdge[a] = t + 1;
+			else
+			{
+				he_set_twin(m, t + 1, prev + 2);
+				hullNext[a] = -1;
+			}
+			stack.push_back(t);
+			prev = t;
+			a = b;
+		}
+
+		//the covered vertices are no longer on the hull, so join the new point to the two ends
+		hullNext[start] = i;
+		hullPrev[i] = start;
+		hullNext[i] = end;
+		hullPrev[end] = i;
+		hullEdge[i] = prev + 2;
+		hash[hash_key(p)] = i;
+		if (start != seedAt)
+			hash[hash_key(m.points[start])] = start;
+
+		legalize(m, stack, hullEdge);
+
+		//count the triangles made for the new point
+		if (progress != NULL)
+		{
+			int made = he_face_count(m);
+			if (!job_step(*progress, made - faces))
+			{
+				he_reset(m);
+				return false;
+			}
+			faces = made;
+		}
+	}
+
+	//put the vertices back to their places in the sorted points
+	m.points.swap(sorted);
+	for (int& v : m.origin)
+		v = o[v];
+
+	return true;
+}
+
+//this method empties the mesh and copies the points into it, sorted by x then y with duplicates skipped, ready for sweep_hull
+//the mesh keeps the memory of its arrays, so triangulating again into the same mesh reuses it
+static void sorted_points(const vector<point>& points, halfedge_mesh& m)
+{
+	STATS_SPAN("delaunay_sort");
+	he_reset(m);
+	m.points = points;
+	sort(m.points.begin(), m.points.end(), point_less);
+	m.points.erase(unique(m.points.begin(), m.points.end(), [](point p1, point p2) { return p1.x == p2.x && p1.y == p2.y; }), m.points.end());
+}
+
+//this method creates a delaunay triangulation of the given points in the mesh, using a sweep hull
+//the points are copied into the mesh sorted by x then y, with duplicates skipped, which is O(n log n), then swept
+void delaunay(const vector<point>& points, halfedge_mesh& m)
+{
+	STATS_SPAN("delaunay");
+	sorted_points(points, m);
+	sweep_hull(m, NULL);
+}
+
+//this method creates a delaunay triangulation of the given points in the mesh, the same way, counting one step of the progress for each triangle made
+bool delaunay(const vector<point>& points, halfedge_mesh& m, job_progress& progress)
+{
+	STATS_SPAN("delaunay");
+	sorted_points(points, m);
+	return sweep_hull(m, &progress);
+}
+
+//this method creates a delaunay triangulation of the points in the view in the mesh, using a sweep hull
+//the points of a compact view are sorted as 32-bit keys, with the x offset above the y offset so the keys sort by x then y,
+//which moves half the memory of sorting the points themselves, and each key is only turned back into a point once it is in place
+void delaunay(const point_view& v, halfedge_mesh& m)
+{
+	STATS_SPAN("delaunay");
+	he_reset(m);
+
+	if (!v.compact)
+	{
+		m.points.resize(v.count);
+		for (int i = 0; i < v.count; i++)
+			m.points[i] = point{ v.xs[i], v.ys[i] };
+		sort(m.points.begin(), m.points.end(), point_less);
+		m.points.erase(unique(m.points.begin(), m.points.end(), [](point p1, point p2) { return p1.x == p2.x && p1.y == p2.y; }), m.points.end());
+
+		sweep_hull(m, NULL);
+		return;
+	}
+
+	vector<unsigned int> keys(v.count);
+	for (int i = 0; i < v.count; i++)
+		keys[i] = (unsigned int)v.cx[i] << 16 | v.cy[i];
+	sort(keys.begin(), keys.end());
+	keys.erase(unique(keys.begin(), keys.end()), keys.end());
+
+	m.points.resize(keys.size());
+	for (int i = 0; i < keys.size(); i++)
+		m.points[i] = point{ v.origin.x + (int)(keys[i] >> 16), v.origin.y + (int)(keys[i] & 0xFFFF) };
+
+	sweep_hull(m, NULL);
+}
+
+//this method sets the vertices of triangle f in the mesh to a, b and c, leaving its twins as they are
+static void set_triangle(halfedge_mesh& m, int f, int a, int b, int c)
+{
+	m.origin[3 * f] = a;
+	m.origin[3 * f + 1] = b;
+	m.origin[3 * f + 2] = c;
+}
+
+//this method walks from triangle t towards point p over the triangles with the given vertices and twins, returning the triangle that holds p (on its inside or edges)
+//at each triangle, the walk crosses the first edge that has p strictly on its outside, starting from a different edge each step
+//changing the starting edge keeps the walk from going around in circles, which can happen in a triangulation that is not delaunay
+//if the edge to cross is on the boundary, p is outside the triangles, and the boundary half edge is left in exit (which is -1 otherwise)
+static int walk(const vector<point>& points, const vector<int>& origin, const vector<int>& twin, point p, int t, int& exit)
+{
+	unsigned int step = t;
+	exit = -1;
+
+	for (;;)
+	{
+		step = step * 1103515245 + 12345;
+		int first = (step >> 16) % 3;
+
+		int crossed = -1;
+		for (int k = 0; k < 3 && crossed == -1; k++)
+		{
+			int h = 3 * t + (first + k) % 3;
+			if (orient2d(points[origin[h]], points[origin[h - h % 3 + (h + 1) % 3]], p) < 0)
+				crossed = h;
+		}
+
+		if (crossed == -1)
+			return t;
+
+		if (twin[crossed] == -1)
+		{
+			exit = crossed;
+			return t;
+		}
+
+		t = twin[crossed] / 3;
+	}
+}
+
+//this method walks from triangle t of the mesh towards point p, returning the triangle that holds p (on its inside or edges)
+//if the edge to cross is on the hull, p is outside the triangulation, and the hull half edge is left in exit (which is -1 otherwise)
+static int locate(const halfedge_mesh& m, point p, int t, int& exit)
+{
+	return walk(m.points, m.origin, m.twin, p, t, exit);
+}
+
+//this method returns the hull half edge after hull half edge h going counter clockwise, found by turning around the vertex h ends at
+static int hull_next(const halfedge_mesh& m, int h)
+{
+	int e = he_next(m, h);
+	while (m.twin[e] != -1)
+		e = he_next(m, m.twin[e]);
+
+	return e;
+}
+
+//this method returns the hull half edge before hull half edge h going counter clockwise, found by turning around the vertex h starts at
+static int hull_prev(const halfedge_mesh& m, int h)
+{
+	int e = he_prev(m, h);
+	while (m.twin[e] != -1)
+		e = he_prev(m, m.twin[e]);
+
+	return e;
+}
+
+//this method inserts point p into the triangulation in the mesh, then flips edges around it until the triangles around it are delaunay
+//the triangle holding p is found by walking from triangle hint, which is then set to a triangle touching p, so the next point near it is found quickly
+//a point inside a triangle splits it into three, a point on an edge splits the triangles on both sides of it into two each,
+//and a point outside the hull is joined to every hull edge it can see, which are found by walking the hull both ways from where the walk left it
+//only the edges opposite p can stop being delaunay, so they are legalized the same way the sweep hull does, which only touches the triangles near p
+//a mesh with no triangles yet (less than three points, or all colinear) is triangulated again with the new point instead
+//returns false if p is already a vertex of the mesh
+bool tri_insert(halfedge_mesh& m, point p, int& hint)
+{
+	int faces = he_face_count(m);
+	if (faces == 0)
+	{
+		for (const point& q : m.points)
+			if (q.x == p.x && q.y == p.y)
+				return false;
+
+		vector<point> points = m.points;
+		points.push_back(p);
+		delaunay(points, m);
+		hint = 0;
+		return true;
+	}
+
+	//find the triangle holding p, or the hull edge the walk left through
+	int exit;
+	int t = locate(m, p, hint >= 0 && hint < faces ? hint : 0, exit);
+
+	//if p is one of the corners of the triangle, it is already in the mesh
+	for (int i = 0; i < 3; i++)
+	{
+		point q = m.points[m.origin[3 * t + i]];
+		if (q.x == p.x && q.y == p.y)
+			return false;
+	}
+
+	int v = m.points.size();
+	m.points.push_back(p);
+
+	vector<int> stack, noHull;
+
+	if (exit != -1)
+	{
+		//walk back and then forward along the hull from the hull edge the walk left through, to find the visible hull edges
+		STATS_ADD(STAT_INSERT_OUTSIDE, 1);
+		int start = exit, end = exit;
+		for (int h = hull_prev(m, start); h != exit && orient2d(m.points[m.origin[h]], m.points[m.origin[he_next(m, h)]], p) < 0; h = hull_prev(m, h))
+			start = h;
+		for (int h = hull_next(m, end); h != start && orient2d(m.points[m.origin[h]], m.points[m.origin[he_next(m, h)]], p) < 0; h = hull_next(m, h))
+			end = h;
+
+		//add a triangle (b, a, p) for each visible hull edge a b, with its first half edge across the hull edge and its second joined to the triangle before it
+		int prev = -1;
+		for (int h = start; ; h = hull_next(m, h))
+		{
+			int a = m.origin[h], b = m.origin[he_next(m, h)];
+			bool last = h == end;
+
+			int f = 3 * he_add_triangle(m, b, a, v);
+			he_set_twin(m, f, h);
+			if (prev != -1)
+				he_set_twin(m, f + 1, prev + 2);
+			stack.push_back(f);
+			prev = f;
+
+			if (last)
+				break;
+		}
+
+		hint = prev / 3;
+	}
+	else
+	{
+		//find the edge of the triangle that p is on, if any
+		int on = -1;
+		for (int i = 0; i < 3; i++)
+		{
+			int h = 3 * t + i;
+			if (orient2d(m.points[m.origin[h]], m.points[m.origin[he_next(m, h)]], p) == 0)
+				on = h;
+		}
+
+		if (on == -1)
+		{
+			//split triangle (a, b, c) into (a, b, p), (b, c, p) and (c, a, p)
+			STATS_ADD(STAT_INSERT_TRISECTS, 1);
+			int a = m.origin[3 * t], b = m.origin[3 * t + 1], c = m.origin[3 * t + 2];
+			int bc = m.twin[3 * t + 1], ca = m.twin[3 * t + 2];
+
+			int t1 = he_add_triangle(m, b, c, v), t2 = he_add_triangle(m, c, a, v);
+			set_triangle(m, t, a, b, v);
+			he_set_twin(m, 3 * t1, bc);
+			he_set_twin(m, 3 * t2, ca);
+			he_set_twin(m, 3 * t + 1, 3 * t1 + 2);
+			he_set_twin(m, 3 * t1 + 1, 3 * t2 + 2);
+			he_set_twin(m, 3 * t2 + 1, 3 * t + 2);
+
+			stack.push_back(3 * t);
+			stack.push_back(3 * t1);
+			stack.push_back(3 * t2);
+		}
+		else
+		{
+			//the edge goes from a to b, with c opposite it and d opposite it in the other triangle (if there is one)
+			int g = m.twin[on];
+			int a = m.origin[on], b = m.origin[he_next(m, on)], c = m.origin[he_prev(m, on)];
+			int bc = m.twin[he_next(m, on)], ca = m.twin[he_prev(m, on)];
+
+			//split (a, b, c) into (a, p, c) and (p, b, c)
+			STATS_ADD(STAT_INSERT_EDGE_SPLITS, 1);
+			int t1 = he_add_triangle(m, v, b, c);
+			set_triangle(m, t, a, v, c);
+			m.twin[3 * t] = -1;
+			he_set_twin(m, 3 * t + 2, ca);
+			he_set_twin(m, 3 * t1 + 1, bc);
+			he_set_twin(m, 3 * t + 1, 3 * t1 + 2);
+			stack.push_back(3 * t + 2);
+			stack.push_back(3 * t1 + 1);
+
+			if (g != -1)
+			{
+				//split (b, a, d) into (b, p, d) and (p, a, d)
+				int u = g / 3;
+				int d = m.origin[he_prev(m, g)];
+				int ad = m.twin[he_next(m, g)], db = m.twin[he_prev(m, g)];
+
+				int u1 = he_add_triangle(m, v, a, d);
+				set_triangle(m, u, b, v, d);
+				he_set_twin(m, 3 * u + 2, db);
+				he_set_twin(m, 3 * u1 + 1, ad);
+				he_set_twin(m, 3 * u + 1, 3 * u1 + 2);
+
+				//join the two halves across the split edge
+				he_set_twin(m, 3 * t, 3 * u1);
+				he_set_twin(m, 3 * t1, 3 * u);
+				stack.push_back(3 * u + 2);
+				stack.push_back(3 * u1 + 1);
+			}
+			else
+				m.twin[3 * t1] = -1;
+		}
+
+		hint = t;
+	}
+
+	//every edge on the stack has p opposite it, which is what legalize expects
+	legalize(m, stack, noHull);
+
+	return true;
+}
+
+//this method checks if the edge of half edge h should be flipped by the cleanup, based on the given criterion
+//with CLEANUP_DELAUNAY, the edge is flipped when the point on the other side of it is inside the circle of the triangle
+//with CLEANUP_SHORTER, the edge is flipped when the other diagonal of the quad is shorter, as long as the quad is convex
+static bool should_flip(const halfedge_mesh& m, int h, int method)
+{
+	int g = m.twin[h];
+	if (g == -1)
+		return false;
+
+	//the edge goes from a to b, with c opposite it and d opposite it in the other triangle
+	point a = m.points[m.origin[h]], b = m.points[m.origin[he_next(m, h)]], c = m.points[m.origin[he_prev(m, h)]];
+	point d = m.points[m.origin[he_prev(m, g)]];
+
+	if (method == CLEANUP_DELAUNAY)
+		return incircle(a, b, c, d) > 0;
+
+	//if the points making up the edge are not on opposite sides of the new edge, the quad is not convex and we don't have a better edge
+	int da = orient2d(c, d, a), db = orient2d(c, d, b);
+	if (!((da > 0 && db < 0) || (da < 0 && db > 0)))
+		return false;
+
+	//compare the lengths of the two diagonals
+	return compare_length(c, d, a, b) < 0;
+}
+
+//this method implements a triangle cleanup algorithm using a worklist of edges to check
+//every edge between two triangles starts on the worklist, and each edge taken off it is flipped if should_flip says so
+//after a flip, the four outside edges of the quad go back on the worklist, as they are the only edges whose checks can change
+//both criteria only ever improve the triangulation, so the cleanup ends, and the number of flips made is returned
+int tri_cleanup(halfedge_mesh& m, int method)
+{
+	STATS_SPAN("tri_cleanup");
+	int trisCleaned = 0;
+
+	//put one half edge of every edge that has a triangle on the other side on the worklist
+	vector<int> work;
+	vector<bool> queued(m.origin.size(), false);
+	for (int h = 0; h < m.origin.size(); h++)
+	{
+		if (m.twin[h] > h)
+		{
+			work.push_back(h);
+			queued[h] = true;
+		}
+	}
+
+	while (!work.empty())
+	{
+		int h = work.back();
+		work.pop_back();
+		queued[h] = false;
+
+		STATS_ADD(STAT_CLEANUP_TESTS, 1);
+		if (!should_flip(m, h, method))
+			continue;
+
+		int t = h - h % 3, n = m.twin[h] - m.twin[h] % 3;
+		he_flip(m, h);
+		trisCleaned++;
+		STATS_ADD(STAT_CLEANUP_FLIPS, 1);
+
+		//put the outside edges of the quad back on the worklist
+		int edges[4] = { t, t + 1, n + 1, n + 2 };
+		for (int e : edges)
+		{
+			if (!queued[e] && m.twin[e] != -1)
+			{
+				work.push_back(e);
+				queued[e] = true;
+			}
+		}
+	}
+
+	return trisCleaned;
+}
+
+//this method starts the constraints of the triangulation in the mesh, with no constraint edges
+void constrain_init(tri_constraints& c, const halfedge_mesh& m)
+{
+	c.fixed.assign(m.origin.size(), 0);
+	c.vertexEdge.assign(m.points.size(), -1);
+	for (int h = 0; h < m.origin.size(); h++)
+		c.vertexEdge[m.origin[h]] = h;
+	c.crossed.clear();
+	c.made.clear();
+	c.holeOrigin.clear();
+	c.holeTwin.clear();
+}
+
+//this method returns the first half edge going out of vertex v counter clockwise, so turning counter clockwise from it visits every half edge out of v
+//that is any of them for a vertex inside the triangulation, and the one along the boundary for a vertex on it
+//returns -1 if v has no triangles
+static int first_out(const halfedge_mesh& m, const tri_constraints& c, int v)
+{
+	int start = c.vertexEdge[v];
+	if (start == -1)
+		return -1;
+
+	//turn clockwise, from each half edge out of v to the half edge after its twin, until the boundary or back to the start
+	int h = start;
+	while (m.twin[h] != -1)
+	{
+		int g = he_next(m, m.twin[h]);
+		if (g == start)
+			return start;
+		h = g;
+	}
+
+	return h;
+}
+
+//this method returns the half edge after h turning counter clockwise around the vertex h goes out of, or -1 past the boundary
+static inline int next_out(const halfedge_mesh& m, int h)
+{
+	return m.twin[he_prev(m, h)];
+}
+
+//this method returns the half edge from vertex a to vertex b, or -1 if there is none, turning around a
+static int find_edge(const halfedge_mesh& m, const tri_constraints& c, int a, int b)
+{
+	int first = first_out(m, c, a);
+	for (int h = first; h != -1; )
+	{
+		if (he_target(m, h) == b)
+			return h;
+
+		h = next_out(m, h);
+		if (h == first)
+			break;
+	}
+
+	return -1;
+}
+
+//this method returns the half edge of the edge between vertices a and b, whichever way it goes, or -1 if there is no such edge
+static int find_either_edge(const halfedge_mesh& m, const tri_constraints& c, int a, int b)
+{
+	int h = find_edge(m, c, a, b);
+	return h != -1 ? h : find_edge(m, c, b, a);
+}
+
+//this method flips the edge of half edge h with he_flip, moving the constraint counts of the four outside edges of the quad with them
+//h goes from a to b with p opposite it, and its twin has q opposite it, so the face of h then has p a, a q and q p, and the face of the twin has p q, q b and b p
+static void constrained_flip(halfedge_mesh& m, tri_constraints& c, int h)
+{
+	int g = m.twin[h];
+	int t = h - h % 3, n = g - g % 3;
+	int a = m.origin[h], b = m.origin[he_next(m, h)], p = m.origin[he_prev(m, h)], q = m.origin[he_prev(m, g)];
+	int fbp = c.fixed[he_next(m, h)], fpa = c.fixed[he_prev(m, h)], faq = c.fixed[he_next(m, g)], fqb = c.fixed[he_prev(m, g)];
+
+	he_flip(m, h);
+	STATS_ADD(STAT_CONSTRAIN_FLIPS, 1);
+
+	c.fixed[t] = fpa;
+	c.fixed[t + 1] = faq;
+	c.fixed[t + 2] = 0;
+	c.fixed[n] = 0;
+	c.fixed[n + 1] = fqb;
+	c.fixed[n + 2] = fbp;
+
+	c.vertexEdge[a] = t + 1;
+	c.vertexEdge[b] = n + 2;
+	c.vertexEdge[p] = t;
+	c.vertexEdge[q] = n + 1;
+}
+
+//this method walks along the segment from vertex a to vertex b, through the triangles it crosses, to the first vertex on the segment
+//that is b, or a vertex in the way, as the segment can run through other vertices
+//the edges crossed are added to crossed as pairs of vertices, with the one on the right of the segment first
+//returns the vertex reached, or -1 if the segment crosses a constraint edge (or leaves the triangulation)
+static int walk_segment(const halfedge_mesh& m, const tri_constraints& c, int a, int b, vector<int>& crossed)
+{
+	point pa = m.points[a], pb = m.points[b];
+
+	//find the triangle around a that the segment leaves a through, or a vertex on the segment joined to a
+	//a vertex joined to a on the line through a and b is on the segment when it is on the same side of a as b, as no edge runs through a vertex
+	int e = -1;
+	int first = first_out(m, c, a);
+	for (int h = first; h != -1; )
+	{
+		int u = he_target(m, h), w = m.origin[he_prev(m, h)];
+		if (u == b || w == b)
+			return b;
+
+		point pu = m.points[u], pw = m.points[w];
+		if (orient2d(pa, pb, pu) == 0 && point_less(pa, pu) == point_less(pa, pb))
+			return u;
+		if (orient2d(pa, pb, pw) == 0 && point_less(pa, pw) == point_less(pa, pb))
+			return w;
+
+		//the segment leaves through the edge u w, going from the right of the segment to the left, when b is between u and w
+		if (orient2d(pa, pu, pb) > 0 && orient2d(pa, pw, pb) < 0)
+		{
+			e = he_next(m, h);
+			break;
+		}
+
+		h = next_out(m, h);
+		if (h == first)
+			break;
+	}
+
+	//cross triangles until the segment gets to a vertex, each one entered through an edge going from the right to the left
+	while (e != -1)
+	{
+		int g = m.twin[e];
+		if (c.fixed[e] > 0 || g == -1)
+			return -1;
+
+		crossed.push_back(m.origin[e]);
+		crossed.push_back(he_target(m, e));
+
+		//the triangle on the other side is (w, u, x), so the segment leaves through x w if x is on the right and through u x if it is on the left
+		int x = m.origin[he_prev(m, g)];
+		if (x == b)
+			return b;
+
+		int side = orient2d(pa, pb, m.points[x]);
+		if (side == 0)
+			return x;
+		e = side < 0 ? he_prev(m, g) : he_next(m, g);
+	}
+
+	return -1;
+}
+
+//this method flips away the edges crossing the segment from vertex a to vertex b (in c.crossed) until the edge a b is in the mesh
+//a crossing edge is only flipped once the quad around it is convex, otherwise it goes to the back of the list until the flips around it have changed the quad,
+//and the new edge of a flip goes to the back too if it still crosses the segment, which always ends with no crossing edges left (Sloan's method)
+//the edges are held as pairs of vertices, which stay the same across flips where half edges don't, and the new edges that don't cross the segment are added to c.made
+static void force_edge(halfedge_mesh& m, tri_constraints& c, int a, int b)
+{
+	point pa = m.points[a], pb = m.points[b];
+	vector<int>& crossed = c.crossed;
+	for (int i = 0; i < crossed.size(); i += 2)
+	{
+		int u = crossed[i], w = crossed[i + 1];
+		int h = find_edge(m, c, u, w);
+		int p = m.origin[he_prev(m, h)], q = m.origin[he_prev(m, m.twin[h])];
+
+		//the quad is convex when u and w are on opposite sides of the other diagonal
+		int su = orient2d(m.points[p], m.points[q], m.points[u]), sw = orient2d(m.points[p], m.points[q], m.points[w]);
+		if (!((su > 0 && sw < 0) || (su < 0 && sw > 0)))
+		{
+			crossed.push_back(u);
+			crossed.push_back(w);
+			continue;
+		}
+
+		constrained_flip(m, c, h);
+
+		//the new edge goes from p to q, keep it with the vertex on the right of the segment first if it still crosses
+		int sp = orient2d(pa, pb, m.points[p]), sq = orient2d(pa, pb, m.points[q]);
+		vector<int>& to = (sp < 0 && sq > 0) || (sp > 0 && sq < 0) ? crossed : c.made;
+		to.push_back(sp < 0 ? p : q);
+		to.push_back(sp < 0 ? q : p);
+	}
+
+	crossed.clear();
+}
+
+//this method flips the edges in c.made until every edge near them that isn't a constraint edge is delaunay, the same way as legalize
+//after a flip the four outside edges of the quad are checked too, and an edge that has been flipped away since it was added is skipped
+static void legalize_constrained(halfedge_mesh& m, tri_constraints& c)
+{
+	vector<int>& made = c.made;
+	while (!made.empty())
+	{
+		int w = made.back();
+		made.pop_back();
+		int u = made.back();
+		made.pop_back();
+
+		int h = find_either_edge(m, c, u, w);
+		if (h == -1 || m.twin[h] == -1 || c.fixed[h] > 0)
+			continue;
+
+		//the edge goes from a to b, with p opposite it and q opposite it in the other triangle
+		int a = m.origin[h], b = m.origin[he_next(m, h)], p = m.origin[he_prev(m, h)], q = m.origin[he_prev(m, m.twin[h])];
+		if (incircle(m.points[a], m.points[b], m.points[p], m.points[q]) <= 0)
+			continue;
+
+		constrained_flip(m, c, h);
+		int edges[8] = { p, a, a, q, q, b, b, p };
+		made.insert(made.end(), edges, edges + 8);
+	}
+}
+
+//this method puts the edge between vertices a and b into the triangulation as a constraint edge
+//the whole edge is walked first, so nothing is flipped when it crosses a constraint edge, then the edge between each vertex on it and the next is forced in,
+//counted as a constraint, and the edges made by forcing it in are made delaunay, which only touches the triangles the edge crossed and the ones near them
+bool tri_constrain(halfedge_mesh& m, tri_constraints& c, int a, int b)
+{
+	if (a == b)
+		return true;
+	if (he_face_count(m) == 0)
+		return false;
+
+	for (int v = a; v != b; )
+	{
+		c.crossed.clear();
+		v = walk_segment(m, c, v, b, c.crossed);
+		if (v == -1)
+		{
+			c.crossed.clear();
+			return false;
+		}
+	}
+
+	for (int v = a; v != b; )
+	{
+		c.crossed.clear();
+		int x = walk_segment(m, c, v, b, c.crossed);
+		force_edge(m, c, v, x);
+
+		int h = find_either_edge(m, c, v, x);
+		c.fixed[h]++;
+		if (m.twin[h] != -1)
+			c.fixed[m.twin[h]]++;
+		STATS_ADD(STAT_CONSTRAIN_EDGES, 1);
+
+		legalize_constrained(m, c);
+		v = x;
+	}
+
+	return true;
+}
+
+//this method removes the triangles that are not inside an odd number of constraint rings
+//the triangles are flooded from one on the boundary, which is inside when its boundary edge is on an odd number of rings,
+//and crossing an edge on an odd number of rings goes from inside to outside or back, which is the same whichever way a triangle is reached
+//the triangles that are kept are then moved down over the removed ones, in the same order, with their twins renumbered
+//the removed triangles are kept in the constraints, numbered on from the kept ones, so a point locator can still walk across the holes
+int tri_drop_holes(halfedge_mesh& m, tri_constraints& c)
+{
+	int faces = he_face_count(m);
+	int start = -1;
+	for (int h = 0; h < m.origin.size() && start == -1; h++)
+		if (m.twin[h] == -1)
+			start = h;
+	c.holeOrigin.clear();
+	c.holeTwin.clear();
+	if (start == -1)
+		return 0;
+
+	//flood the triangles, marking each one as inside (1) or outside (0)
+	vector<signed char> inside(faces, -1);
+	vector<int> stack;
+	inside[start / 3] = c.fixed[start] % 2;
+	stack.push_back(start / 3);
+	while (!stack.empty())
+	{
+		int f = stack.back();
+		stack.pop_back();
+		for (int h = 3 * f; h < 3 * f + 3; h++)
+		{
+			int g = m.twin[h];
+			if (g == -1 || inside[g / 3] != -1)
+				continue;
+
+			inside[g / 3] = inside[f] ^ (c.fixed[h] % 2);
+			stack.push_back(g / 3);
+		}
+	}
+
+	//number the triangles that are kept, then the removed ones after them
+	vector<int> at(faces);
+	int count = 0;
+	for (int f = 0; f < faces; f++)
+		if (inside[f] == 1)
+			at[f] = count++;
+
+	int next = count;
+	for (int f = 0; f < faces; f++)
+		if (inside[f] != 1)
+			at[f] = next++;
+
+	//keep the removed triangles, and the twins of every half edge in the new numbering, so the point locator can walk through the holes
+	if (count < faces)
+	{
+		c.holeOrigin.resize(3 * (faces - count));
+		c.holeTwin.resize(3 * faces);
+		for (int h = 0; h < m.origin.size(); h++)
+		{
+			int f = h / 3, g = m.twin[h];
+			c.holeTwin[3 * at[f] + h % 3] = g == -1 ? -1 : 3 * at[g / 3] + g % 3;
+			if (at[f] >= count)
+				c.holeOrigin[3 * (at[f] - count) + h % 3] = m.origin[h];
+		}
+	}
+
+	//move the kept triangles down, which never writes over a triangle that hasn't been moved yet
+	for (int f = 0; f < faces; f++)
+	{
+		if (at[f] >= count)
+			continue;
+
+		for (int i = 0; i < 3; i++)
+		{
+			int h = 3 * f + i, to = 3 * at[f] + i;
+			int g = m.twin[h];
+			m.origin[to] = m.origin[h];
+			m.twin[to] = g == -1 || at[g / 3] >= count ? -1 : 3 * at[g / 3] + g % 3;
+			c.fixed[to] = c.fixed[h];
+		}
+	}
+
+	m.origin.resize(3 * count);
+	m.twin.resize(3 * count);
+	m.faceEdge.resize(count);
+	c.fixed.resize(3 * count);
+
+	c.vertexEdge.assign(m.points.size(), -1);
+	for (int h = 0; h < m.origin.size(); h++)
+		c.vertexEdge[m.origin[h]] = h;
+
+	return faces - count;
+}
+
+//this method creates a constrained delaunay triangulation of the points, triangulating them with delaunay then putting in every ring edge with tri_constrain
+//the mesh has its own sorted copy of the points without duplicates, so each ring vertex is looked up in it, and an edge between two copies of a point is skipped
+//a ring is closed, so its last vertex is joined to its first, and a ring that runs back along itself (like a line of colinear points) puts each edge in twice,
+//which leaves it on an even number of rings, so it doesn't make a hole
+//when there is a progress (it can be NULL), each triangle made and each ring edge put in is counted as a step, and the mesh is left empty if it is cancelled
+static bool constrained_delaunay_of(const vector<point>& points, const vector<vector<int>>& rings, bool holes, halfedge_mesh& m, tri_constraints& c, job_progress* progress)
+{
+	STATS_SPAN("constrained_delaunay");
+	if (progress == NULL)
+		delaunay(points, m);
+	else if (!delaunay(points, m, *progress))
+	{
+		constrain_init(c, m);
+		return false;
+	}
+	constrain_init(c, m);
+	if (he_face_count(m) == 0)
+		return true;
+
+	bool ok = true;
+	vector<int> verts;
+	for (const vector<int>& ring : rings)
+	{
+		verts.clear();
+		for (int i : ring)
+			verts.push_back(lower_bound(m.points.begin(), m.points.end(), points[i], point_less) - m.points.begin());
+
+		if (verts.size() < 2)
+			continue;
+		for (int i = 0; i < verts.size(); i++)
+		{
+			if (!tri_constrain(m, c, verts[i], verts[(i + 1) % verts.size()]))
+				ok = false;
+
+			if (progress != NULL && !job_step(*progress, 1))
+			{
+				he_reset(m);
+				constrain_init(c, m);
+				return false;
+			}
+		}
+	}
+
+	if (holes)
+		tri_drop_holes(m, c);
+	return ok;
+}
+
+//this method creates a constrained delaunay triangulation of the given points in the mesh, keeping the edges of each ring as constraints
+bool constrained_delaunay(const vector<point>& points, const vector<vector<int>>& rings, bool holes, halfedge_mesh& m, tri_constraints& c)
+{
+	return constrained_delaunay_of(points, rings, holes, m, c, NULL);
+}
+
+//this method creates a constrained delaunay triangulation the same way, counting one step of the progress for each triangle made and each ring edge put in
+bool constrained_delaunay(const vector<point>& points, const vector<vector<int>>& rings, bool holes, halfedge_mesh& m, tri_constraints& c, job_progress& progress)
+{
+	return constrained_delaunay_of(points, rings, holes, m, c, &progress);
+}
+
+//this method builds a point locator over the triangles in the mesh and the removed triangles in the constraints (holes can be NULL)
+//the cell size is picked so there are about two triangles in each cell, like the grid used by the cluster peel
+//the start triangle of each cell is found by walking to the cell centre from the start triangle of the cell before it,
+//going back and forth along the rows so each walk is only one cell long, which makes the build O(n) overall
+//cells whose centre is outside the triangulation keep the hull triangle the walk stopped at
+//when triangles were removed, the locator gets its own copy of the half edges with the removed triangles after the mesh's, so the walks can cross the holes,
+//and only the outside of the hull around all of them is a boundary
+static void locator_build_of(tri_locator& l, const halfedge_mesh& m, const tri_constraints* holes)
+{
+	STATS_SPAN("locator_build");
+	//find the extents of the points
+	int xMin = INT_MAX, xMax = INT_MIN, yMin = INT_MAX, yMax = INT_MIN;
+	for (const point& p : m.points)
+	{
+		xMin = min(p.x, xMin);
+		xMax = max(p.x, xMax);
+		yMin = min(p.y, yMin);
+		yMax = max(p.y, yMax);
+	}
+
+	//set up the grid dimensions, making sure there is at least one cell
+	int faces = he_face_count(m);
+	long long w = m.points.empty() ? 1 : (long long)xMax - xMin + 1;
+	long long h = m.points.empty() ? 1 : (long long)yMax - yMin + 1;
+	l.minX = m.points.empty() ? 0 : xMin;
+	l.minY = m.points.empty() ? 0 : yMin;
+	l.faces = faces;
+	l.origin.clear();
+	l.twin.clear();
+	if (holes != NULL && !holes->holeTwin.empty())
+	{
+		l.origin.assign(m.origin.begin(), m.origin.end());
+		l.origin.insert(l.origin.end(), holes->holeOrigin.begin(), holes->holeOrigin.end());
+		l.twin.assign(holes->holeTwin.begin(), holes->holeTwin.end());
+	}
+
+	int walkable = l.origin.empty() ? faces : l.origin.size() / 3;
+	l.cellSize = max(1, (int)sqrt((double)w * h / max(1, walkable / 2)));
+	l.cols = (int)(w / l.cellSize) + 1;
+	l.rows = (int)(h / l.cellSize) + 1;
+	l.start.assign(l.cols * l.rows, -1);
+
+	if (faces == 0)
+		return;
+
+	const vector<int>& origin = l.origin.empty() ? m.origin : l.origin;
+	const vector<int>& twin = l.twin.empty() ? m.twin : l.twin;
+	int t = 0, exit;
+	for (int r = 0; r < l.rows; r++)
+	{
+		for (int i = 0; i < l.cols; i++)
+		{
+			int c = r % 2 == 0 ? i : l.cols - 1 - i;
+			point centre = point{ (int)min((long long)INT_MAX, l.minX + (long long)c * l.cellSize + l.cellSize / 2), (int)min((long long)INT_MAX, l.minY + (long long)r * l.cellSize + l.cellSize / 2) };
+			t = walk(m.points, origin, twin, centre, t, exit);
+			l.start[r * l.cols + c] = t;
+		}
+	}
+}
+
+//this method builds a point locator over the triangles in the mesh, which has to be rebuilt if the mesh changes
+void locator_build(tri_locator& l, const halfedge_mesh& m)
+{
+	locator_build_of(l, m, NULL);
+}
+
+//this method builds a point locator over the triangles in a mesh whose holes were removed with tri_drop_holes, walking across the holes with the removed triangles in c
+void locator_build(tri_locator& l, const halfedge_mesh& m, const tri_constraints& c)
+{
+	locator_build_of(l, m, &c);
+}
+
+//this method returns a triangle of the mesh touching q, when the walk of the locator stopped at q in removed triangle t, or -1 if q is inside the hole
+//a q on the boundary of a hole is in a triangle on both sides, so the kept one is found by turning around the vertex q is on, or crossing the edge it is on
+static int kept_side(const tri_locator& l, const halfedge_mesh& m, int t, point q)
+{
+	for (int h = 3 * t; h < 3 * t + 3; h++)
+	{
+		point p = m.points[l.origin[h]];
+		if (p.x != q.x || p.y != q.y)
+			continue;
+
+		//turn one way around the vertex from h, through the edge before each half edge, then the other way if that reaches the hull
+		int e = h;
+		do
+		{
+			if (e / 3 < l.faces)
+				return e / 3;
+			e = l.twin[e - e % 3 + (e + 2) % 3];
+		} while (e != -1 && e != h);
+
+		for (e = e == h ? -1 : l.twin[h]; e != -1; e = l.twin[e])
+		{
+			e = e - e % 3 + (e + 1) % 3;
+			if (e / 3 < l.faces)
+				return e / 3;
+		}
+		return -1;
+	}
+
+	for (int h = 3 * t; h < 3 * t + 3; h++)
+		if (l.twin[h] != -1 && l.twin[h] / 3 < l.faces && orient2d(m.points[l.origin[h]], m.points[l.origin[h - h % 3 + (h + 1) % 3]], q) == 0)
+			return l.twin[h] / 3;
+
+	return -1;
+}
+
+//this method returns the triangle of the mesh that holds q (on its inside or edges), or -1 if q is outside the triangulation or in one of its holes
+//the walk starts from the triangle stored for the cell q is in, so it only takes a few steps
+//queries outside the grid start from the nearest cell, and reach the hull on their way out
+//a walk that ends in one of the removed triangles the locator keeps is in a hole (or on its boundary), since they are numbered after the triangles of the mesh
+int locator_find(const tri_locator& l, const halfedge_mesh& m, point q)
+{
+	if (l.start.empty() || l.start[0] == -1)
+		return -1;
+
+	long long c = ((long long)q.x - l.minX) / l.cellSize, r = ((long long)q.y - l.minY) / l.cellSize;
+	c = max(0LL, min((long long)l.cols - 1, c));
+	r = max(0LL, min((long long)l.rows - 1, r));
+
+	int exit;
+	int t = l.origin.empty() ? locate(m, q, l.start[r * l.cols + c], exit) : walk(m.points, l.origin, l.twin, q, l.start[r * l.cols + c], exit);
+
+	if (exit != -1)
+		return -1;
+
+	return t < l.faces ? t : kept_side(l, m, t, q);
+}
+
+//this method finds the triangle holding each of the query points, filling faces with one triangle (or -1) for each, using up to the given number of threads
+//the locator and mesh are only read, so the queries are split into one chunk for each thread with no locking, like the parallel hull
+//small batches are not worth starting threads for, so they are answered on the calling thread
+void locator_find_all(const tri_locator& l, const halfedge_mesh& m, const vector<point>& queries, int threads, vector<int>& faces)
+{
+	STATS_SPAN("locate_all");
+	int n = queries.size();
+	faces.assign(n, -1);
+
+	threads = max(1, min(threads, n / LOCATE_CHUNK_MIN));
+	if (threads == 1)
+	{
+		for (int i = 0; i < n; i++)
+			faces[i] = locator_find(l, m, queries[i]);
+		return;
+	}
+
+	vector<thread> workers;
+	for (int t = 0; t < threads; t++)
+	{
+		workers.push_back(thread([&, t]()
+		{
+			int lo = (long long)n * t / threads, hi = (long long)n * (t + 1) / threads;
+			for (int i = lo; i < hi; i++)
+				faces[i] = locator_find(l, m, queries[i]);
+		}));
+	}
+
+	for (thread& w : workers)
+		w.join();
+}
@@ -0,0 +1,101 @@
+/* This is the delaunay triangulation and the edge flip cleanup, shared by the 2D triangulation and the batch tool.
+* Both work on a triangle half edge mesh (see halfedge.h) and don't touch any global state.
+* A triangulation can also be made to keep constraint edges (like the hull layers of a peel), which are put in by flipping away the edges crossing them,
+* and the triangles of the holes between the constraint rings can then be removed, leaving a triangulation of a polygon with holes.
+* A finished triangulation can also be used to look up which triangle holds a point, with the point locator.
+*/
+
+#pragma once
+
+#include <vector>
+#include "halfedge.h"
+#include "store.h"
+#include "job.h"
+
+//enums for the triangle cleanup criteria
+enum {
+	CLEANUP_DELAUNAY, CLEANUP_SHORTER
+};
+
+//this method creates a delaunay triangulation of the given points in the mesh, using a sweep hull
+//the mesh gets its own sorted copy of the points, without duplicates, reusing the memory the mesh already has from an earlier triangulation
+void delaunay(const std::vector<point>& points, halfedge_mesh& m);
+
+//this method creates a delaunay triangulation of the points in the view in the mesh, the same as for the points the view was taken from
+void delaunay(const point_view& v, halfedge_mesh& m);
+
+//this method creates a delaunay triangulation of the given points in the mesh the same way, counting one step of the progress for each triangle made
+//returns false, with an empty mesh, if the progress was cancelled before the last triangle
+bool delaunay(const std::vector<point>& points, halfedge_mesh& m, job_progress& progress);
+
+//this method inserts point p into the triangulation in the mesh, flipping edges around it so the triangles near it are delaunay
+//the search for the triangle holding p starts from triangle hint, which is set to a triangle touching p for the next insertion
+//returns false if p is already a vertex of the mesh
+bool tri_insert(halfedge_mesh& m, point p, int& hint);
+
+//this method flips edges of the triangle mesh until none of them should be flipped under the given criterion (CLEANUP_DELAUNAY or CLEANUP_SHORTER)
+//returns the number of flips made
+int tri_cleanup(halfedge_mesh& m, int method);
+
+//the triangle constraints structure, which constraint edges a triangle mesh keeps, and what is needed to put more constraint edges into it
+typedef struct
+{
+	std::vector<int> fixed; //the number of constraint edges along each half edge (the same for both half edges of an edge), 0 for an edge that can be flipped
+	std::vector<int> vertexEdge; //a half edge going out of each vertex, kept up to date as edges are flipped, or -1 for a vertex with no triangles
+	std::vector<int> crossed, made; //the edges crossing the constraint edge being put in and the edges made by its flips, kept from one constraint edge to the next
+	std::vector<int> holeOrigin; //the vertices of the triangles removed by tri_drop_holes, three for each, numbered on from the triangles kept in the mesh
+	std::vector<int> holeTwin; //the twin of each half edge of the kept and then the removed triangles in that numbering, or empty when none were removed
+} tri_constraints;
+
+//this method starts the constraints of the triangulation in the mesh, with no constraint edges
+void constrain_init(tri_constraints& c, const halfedge_mesh& m);
+
+//this method puts the edge between vertices a and b into the triangulation as a constraint edge, flipping away the edges that cross it,
+//then flips the new edges around it until every edge that isn't a constraint is delaunay (a constrained delaunay triangulation)
+//an edge running through other vertices is put in as the constraint edges between them
+//returns false, leaving the mesh as it was, if the edge crosses a constraint edge or the mesh has no triangles
+bool tri_constrain(halfedge_mesh& m, tri_constraints& c, int a, int b);
+
+//this method removes the triangles outside the constraint rings of the mesh and inside its holes, keeping the ones inside an odd number of rings
+//the vertices of the removed triangles stay in the points of the mesh, and no more constraints or points can be put into the mesh afterwards
+//the removed triangles are kept in holeOrigin and holeTwin of the constraints, for building a point locator that can walk across the holes
+//returns the number of triangles removed
+int tri_drop_holes(halfedge_mesh& m, tri_constraints& c);
+
+//this method creates a constrained delaunay triangulation of the given points in the mesh, keeping the edges of each ring (indices into points, closed) as constraints
+//when holes is true, the triangles outside the rings and inside the holes between them are removed with tri_drop_holes
+//returns false if any edge of a ring crosses another one, in which case that edge is left out
+bool constrained_delaunay(const std::vector<point>& points, const std::vector<std::vector<int>>& rings, bool holes, halfedge_mesh& m, tri_constraints& c);
+
+//this method creates a constrained delaunay triangulation the same way, counting one step of the progress for each triangle made and then each ring edge put in
+//returns false, with an empty mesh, if the progress was cancelled before the last edge (check the cancel flag to tell it apart from a crossing edge)
+bool constrained_delaunay(const std::vector<point>& points, const std::vector<std::vector<int>>& rings, bool holes, halfedge_mesh& m, tri_constraints& c, job_progress& progress);
+
+//the smallest number of queries worth giving to each thread of a batch point location
+const int LOCATE_CHUNK_MIN = 10000;
+
+//the point locator structure, used to find the triangle of a finished triangulation that holds a point
+//a uniform grid over the mesh stores a triangle near the centre of each cell, and each query walks to its triangle from the one in its cell
+//a mesh with holes removed by tri_drop_holes is walked together with its removed triangles, so the walks are not stopped by the boundary of a hole
+typedef struct
+{
+	int minX, minY; //the bottom left corner of the grid
+	int cellSize; //the width and height of each cell
+	int cols, rows; //the number of cells across and up the grid
+	std::vector<int> start; //the triangle to start walking from for each cell, row by row
+	int faces; //the number of triangles in the mesh, any triangle walked to after these is a removed one
+	std::vector<int> origin, twin; //the half edges of the mesh followed by the removed triangles, or empty when the walks use the mesh itself
+} tri_locator;
+
+//this method builds a point locator over the triangles in the mesh, which has to be rebuilt if the mesh changes
+//the walks stop at any boundary edge of the mesh, so a mesh with holes removed has to use the locator built with its constraints
+void locator_build(tri_locator& l, const halfedge_mesh& m);
+
+//this method builds a point locator over the triangles in a mesh whose holes were removed with tri_drop_holes, using the removed triangles kept in c to walk across the holes
+void locator_build(tri_locator& l, const halfedge_mesh& m, const tri_constraints& c);
+
+//this method returns the triangle of the mesh that holds q (on its inside or edges), or -1 if q is outside the triangulation or in one of its holes
+int locator_find(const tri_locator& l, const halfedge_mesh& m, point q);
+
+//this method finds the triangle holding each of the query points, filling faces with one triangle (or -1) for each, using up to the given number of threads
+void locator_find_all(const tri_locator& l, const halfedge_mesh& m, const std::vector<point>& queries, int threads, std::vector<int>& faces);